@@ -1,28 +1,71 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "include/gfrx_cofb.h"
+#include "include/bench_report.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 #define ITERATIONS 100000
 
-static double benchmark_gfrx_encrypt(int iterations) {
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+static unsigned long long read_tsc(void) { return __rdtsc(); }
+#else
+#define HAVE_TSC 0
+static unsigned long long read_tsc(void) { return 0; }
+#endif
+
+typedef void (*gfrx_kernel_fn)(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+
+typedef struct {
+    const char *name;
+    gfrx_kernel_fn fn;
+    int blocks;
+    int (*available)(void);
+} gfrx_kernel_t;
+
+static int always_available(void) { return 1; }
+
+static const gfrx_kernel_t GFRX_KERNELS[] = {
+    { "x1",          gfrx_encrypt_block,             1,  always_available },
+    { "x2",          gfrx_encrypt_blocks_x2,         2,  always_available },
+    { "x4",          gfrx_encrypt_blocks_x4,         4,  always_available },
+    { "x8",          gfrx_encrypt_blocks_x8,         8,  always_available },
+    { "SSE2 x4",     gfrx_encrypt_blocks_sse2_x4,    4,  gfrx_sse2_available },
+    { "AVX2 x8",     gfrx_encrypt_blocks_avx2_x8,    8,  gfrx_avx2_available },
+    { "AVX-512 x16", gfrx_encrypt_blocks_avx512_x16, 16, gfrx_avx512_available },
+};
+
+/* Encrypts iterations blocks with the given kernel; *tsc_cycles receives elapsed TSC ticks. */
+static double benchmark_gfrx_encrypt(int iterations, const gfrx_kernel_t *kernel, double *tsc_cycles) {
     byte_t key[GFRX_KEY_SIZE];
-    byte_t plaintext[GFRX_BLOCK_SIZE];
-    byte_t ciphertext[GFRX_BLOCK_SIZE];
+    byte_t plaintext[16 * GFRX_BLOCK_SIZE];
+    byte_t ciphertext[16 * GFRX_BLOCK_SIZE];
 
     for (int i = 0; i < GFRX_KEY_SIZE; i++) key[i] = i;
-    for (int i = 0; i < GFRX_BLOCK_SIZE; i++) plaintext[i] = i;
+    for (int i = 0; i < 16 * GFRX_BLOCK_SIZE; i++) plaintext[i] = i;
 
     gfrx_ctx_t ctx;
     gfrx_init(&ctx, key);
 
+    int calls = iterations / kernel->blocks;
+
+    unsigned long long tsc_start = read_tsc();
     clock_t start = clock();
-    for (int i = 0; i < iterations; i++) {
-        gfrx_encrypt_block(&ctx, plaintext, ciphertext);
+    for (int i = 0; i < calls; i++) {
+        kernel->fn(&ctx, plaintext, ciphertext);
     }
     clock_t end = clock();
+    unsigned long long tsc_end = read_tsc();
 
+    if (tsc_cycles) {
+        *tsc_cycles = (double)(tsc_end - tsc_start);
+    }
     return ((double)(end - start)) / CLOCKS_PER_SEC;
 }
 
@@ -96,22 +139,191 @@ static double benchmark_cofb_decrypt(int iterations, size_t msg_size) {
     return ((double)(end - start)) / CLOCKS_PER_SEC;
 }
 
-int main() {
+static double benchmark_cofb_encrypt_keyed(int iterations, size_t msg_size) {
+    byte_t key[GFRX_KEY_SIZE];
+    byte_t nonce[GFRX_NONCE_SIZE];
+    byte_t *plaintext = malloc(msg_size);
+    byte_t *ciphertext = malloc(msg_size);
+    byte_t tag[GFRX_TAG_SIZE];
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key[i] = i;
+    for (size_t i = 0; i < msg_size; i++) plaintext[i] = i & 0xFF;
+
+    cofb_key_t ck;
+    cofb_key_init(&ck, key);
+
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i++) {
+        for (int j = 0; j < GFRX_NONCE_SIZE; j++) nonce[j] = (i >> j) & 0xFF;
+        cofb_encrypt_ctx(&ck, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
+    }
+    clock_t end = clock();
+
+    secure_zero(&ck, sizeof(ck));
+    free(plaintext);
+    free(ciphertext);
+
+    return ((double)(end - start)) / CLOCKS_PER_SEC;
+}
+
+/* Encrypts iterations messages as batches of batch_size under one key. */
+static double benchmark_cofb_encrypt_batch(int iterations, size_t msg_size, size_t batch_size) {
+    byte_t key[GFRX_KEY_SIZE];
+    byte_t *nonces = malloc(batch_size * GFRX_NONCE_SIZE);
+    byte_t *plaintext = malloc(batch_size * msg_size);
+    byte_t *ciphertext = malloc(batch_size * msg_size);
+    byte_t *tags = malloc(batch_size * GFRX_TAG_SIZE);
+    cofb_batch_msg_t *msgs = malloc(batch_size * sizeof(*msgs));
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key[i] = i;
+    for (size_t i = 0; i < batch_size * msg_size; i++) plaintext[i] = i & 0xFF;
+    for (size_t m = 0; m < batch_size; m++) {
+        msgs[m] = (cofb_batch_msg_t){ nonces + m * GFRX_NONCE_SIZE, NULL, 0, plaintext + m * msg_size,
+                                      msg_size, ciphertext + m * msg_size, tags + m * GFRX_TAG_SIZE };
+    }
+
+    cofb_key_t ck;
+    cofb_key_init(&ck, key);
+
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i += (int)batch_size) {
+        for (size_t m = 0; m < batch_size; m++) {
+            for (int j = 0; j < GFRX_NONCE_SIZE; j++) nonces[m * GFRX_NONCE_SIZE + j] = ((i + m) >> j) & 0xFF;
+        }
+        cofb_encrypt_batch(&ck, msgs, batch_size);
+    }
+    clock_t end = clock();
+
+    secure_zero(&ck, sizeof(ck));
+    free(nonces);
+    free(plaintext);
+    free(ciphertext);
+    free(tags);
+    free(msgs);
+
+    return ((double)(end - start)) / CLOCKS_PER_SEC;
+}
+
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Wall-clock time of one segmented encryption of msg_size bytes (CPU time would sum over threads). */
+static double benchmark_cofb_segmented(size_t msg_size, unsigned nthreads, int reps) {
+    byte_t key[GFRX_KEY_SIZE];
+    byte_t nonce[GFRX_NONCE_SIZE] = {0};
+    byte_t *plaintext = malloc(msg_size);
+    byte_t *ciphertext = malloc(cofb_segmented_len(msg_size, COFB_SEGMENT_SIZE_DEFAULT));
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key[i] = i;
+    for (size_t i = 0; i < msg_size; i++) plaintext[i] = i & 0xFF;
+
+    cofb_key_t ck;
+    cofb_key_init(&ck, key);
+
+    double start = wall_time();
+    for (int i = 0; i < reps; i++) {
+        nonce[0] = (byte_t)i;
+        cofb_encrypt_segmented(&ck, nonce, NULL, 0, plaintext, msg_size,
+                               COFB_SEGMENT_SIZE_DEFAULT, ciphertext, nthreads);
+    }
+    double end = wall_time();
+
+    secure_zero(&ck, sizeof(ck));
+    free(plaintext);
+    free(ciphertext);
+
+    return (end - start) / reps;
+}
+
+/* The per-nonce fopen/fread of /dev/urandom that gfrx-tool used to do. */
+static void urandom_nonce(byte_t *nonce) {
+    FILE *f = fopen("/dev/urandom", "rb");
+    if (f) {
+        if (fread(nonce, 1, GFRX_NONCE_SIZE, f) != GFRX_NONCE_SIZE) nonce[0] ^= 1;
+        fclose(f);
+    }
+}
+
+#define NONCES_PER_THREAD 10000000
+
+static void *nonce_worker(void *arg) {
+    cofb_nonce_gen_t *gen = arg;
+    byte_t nonce[GFRX_NONCE_SIZE];
+    volatile byte_t sink = 0;
+    for (int i = 0; i < NONCES_PER_THREAD; i++) {
+        cofb_nonce_next(gen, nonce);
+        sink ^= nonce[0];
+    }
+    return NULL;
+}
+
+/* Nonces per second from nthreads threads sharing one generator. */
+static double benchmark_nonce_shared(unsigned nthreads) {
+    cofb_nonce_gen_t gen;
+    pthread_t threads[64];
+    unsigned started = 0;
+
+    cofb_nonce_init(&gen);
+    double start = wall_time();
+    for (unsigned t = 1; t < nthreads && t < 64; t++) {
+        if (pthread_create(&threads[started], NULL, nonce_worker, &gen) == 0) started++;
+    }
+    nonce_worker(&gen);
+    for (unsigned t = 0; t < started; t++) pthread_join(threads[t], NULL);
+    double end = wall_time();
+
+    return (double)(started + 1) * NONCES_PER_THREAD / (end - start);
+}
+
+int main(int argc, char *argv[]) {
+    bench_report_t report;
+    if (bench_report_open_args(&report, "benchmark", argc, argv) != 0) {
+        return 1;
+    }
+
     printf("GFRX+COFB Benchmarks\n\n");
+    printf("Dispatch backend: %s (%zu lanes; override with GFRX_BACKEND)\n\n",
+           gfrx_backend_name(), gfrx_backend_lanes());
 
     printf("GFRX Block Cipher:\n");
 
-    double time_encrypt = benchmark_gfrx_encrypt(ITERATIONS);
+    double time_encrypt = benchmark_gfrx_encrypt(ITERATIONS, &GFRX_KERNELS[0], NULL);
     double blocks_per_sec = ITERATIONS / time_encrypt;
     double mbps_encrypt = (blocks_per_sec * GFRX_BLOCK_SIZE * 8) / 1000000.0;
 
     printf("  Encrypt: %.2f Mbps (%.2f us/op)\n", mbps_encrypt, (time_encrypt * 1000000) / ITERATIONS);
+    bench_report_add(&report, "gfrx_encrypt", "GFRX-128", GFRX_BLOCK_SIZE, 1, mbps_encrypt,
+                     (time_encrypt * 1000000) / ITERATIONS, ITERATIONS);
+
+    for (size_t i = 0; i < sizeof(GFRX_KERNELS)/sizeof(GFRX_KERNELS[0]); i++) {
+        const gfrx_kernel_t *kernel = &GFRX_KERNELS[i];
+        if (!kernel->available()) {
+            continue;
+        }
+        double cycles;
+        int blocks = ITERATIONS * 16;
+        double t = benchmark_gfrx_encrypt(blocks, kernel, &cycles);
+        double bps = blocks / t;
+        printf("  Encrypt %-11s: %7.2f Mblocks/s (%8.2f Mbps)", kernel->name, bps / 1000000.0,
+               (bps * GFRX_BLOCK_SIZE * 8) / 1000000.0);
+        if (HAVE_TSC) {
+            printf(", %.2f cycles/byte", cycles / ((double)blocks * GFRX_BLOCK_SIZE));
+        }
+        printf("\n");
+        bench_report_add(&report, "gfrx_encrypt_blocks", kernel->name, GFRX_BLOCK_SIZE, 1,
+                         (bps * GFRX_BLOCK_SIZE * 8) / 1000000.0, 1000000.0 / bps, blocks);
+    }
 
     double time_decrypt = benchmark_gfrx_decrypt(ITERATIONS);
     blocks_per_sec = ITERATIONS / time_decrypt;
     double mbps_decrypt = (blocks_per_sec * GFRX_BLOCK_SIZE * 8) / 1000000.0;
 
     printf("  Decrypt: %.2f Mbps (%.2f us/op)\n\n", mbps_decrypt, (time_decrypt * 1000000) / ITERATIONS);
+    bench_report_add(&report, "gfrx_decrypt", "GFRX-128", GFRX_BLOCK_SIZE, 1, mbps_decrypt,
+                     (time_decrypt * 1000000) / ITERATIONS, ITERATIONS);
 
     printf("COFB Mode:\n");
 
@@ -125,11 +337,99 @@ int main() {
         double time = benchmark_cofb_encrypt(iter, size);
         double mbps = (iter / time * size * 8) / 1000000.0;
         printf("  %4zu bytes: %.2f Mbps encrypt", size, mbps);
+        bench_report_add(&report, "cofb_encrypt", "GFRX+COFB", size, 1, mbps, time * 1000000 / iter, iter);
 
         time = benchmark_cofb_decrypt(iter, size);
         mbps = (iter / time * size * 8) / 1000000.0;
         printf(", %.2f Mbps decrypt\n", mbps);
+        bench_report_add(&report, "cofb_decrypt", "GFRX+COFB", size, 1, mbps, time * 1000000 / iter, iter);
+    }
+
+    printf("\nCOFB Per-Message Latency (key schedule per call vs reused key):\n");
+
+    size_t small_sizes[] = {16, 32, 64, 256};
+    int small_iters = 200000;
+
+    for (size_t i = 0; i < sizeof(small_sizes)/sizeof(small_sizes[0]); i++) {
+        size_t size = small_sizes[i];
+
+        double time_oneshot = benchmark_cofb_encrypt(small_iters, size);
+        double time_keyed = benchmark_cofb_encrypt_keyed(small_iters, size);
+        double us_oneshot = (time_oneshot * 1000000) / small_iters;
+        double us_keyed = (time_keyed * 1000000) / small_iters;
+
+        printf("  %4zu bytes: %.3f us/msg cofb_encrypt, %.3f us/msg cofb_encrypt_ctx (%.2fx)\n",
+               size, us_oneshot, us_keyed, us_oneshot / us_keyed);
+        bench_report_add(&report, "cofb_latency", "cofb_encrypt", size, 1, size * 8 / us_oneshot,
+                         us_oneshot, small_iters);
+        bench_report_add(&report, "cofb_latency", "cofb_encrypt_ctx", size, 1, size * 8 / us_keyed,
+                         us_keyed, small_iters);
+    }
+
+    printf("\nCOFB Batch (%zu-lane lockstep vs one cofb_encrypt_ctx per message):\n", gfrx_backend_lanes());
+
+    for (size_t i = 0; i < sizeof(small_sizes)/sizeof(small_sizes[0]); i++) {
+        size_t size = small_sizes[i];
+
+        double time_keyed = benchmark_cofb_encrypt_keyed(small_iters, size);
+        double time_batch = benchmark_cofb_encrypt_batch(small_iters, size, 64);
+        double us_keyed = (time_keyed * 1000000) / small_iters;
+        double us_batch = (time_batch * 1000000) / small_iters;
+
+        printf("  %4zu bytes: %.3f us/msg cofb_encrypt_ctx, %.3f us/msg cofb_encrypt_batch (%.2fx)\n",
+               size, us_keyed, us_batch, us_keyed / us_batch);
+        bench_report_add(&report, "cofb_batch", "cofb_encrypt_batch", size, 1, size * 8 / us_batch,
+                         us_batch, small_iters);
+    }
+
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) ncpu = 1;
+    size_t large_size = 16 * 1024 * 1024;
+    printf("\nSegmented COFB scaling (%zu MB, %d KB segments, %ld online CPUs):\n",
+           large_size >> 20, COFB_SEGMENT_SIZE_DEFAULT / 1024, ncpu);
+
+    double base = 0;
+    for (unsigned t = 1; ; t *= 2) {
+        if (t > (unsigned)ncpu) t = (unsigned)ncpu;
+        double time = benchmark_cofb_segmented(large_size, t, 3);
+        double mbps = (large_size * 8) / time / 1000000.0;
+        if (t == 1) base = time;
+        printf("  %2u threads: %8.2f Mbps (%.2fx)\n", t, mbps, base / time);
+        bench_report_add(&report, "cofb_segmented", "GFRX+COFB", large_size, t, mbps, time * 1000000, 3);
+        if (t == (unsigned)ncpu) break;
+    }
+
+    printf("\nNonce generation:\n");
+
+    byte_t nonce[GFRX_NONCE_SIZE];
+    int urandom_iters = 20000;
+    double start = wall_time();
+    for (int i = 0; i < urandom_iters; i++) urandom_nonce(nonce);
+    double urandom_rate = urandom_iters / (wall_time() - start);
+    printf("  fopen(/dev/urandom) per nonce: %10.2f M nonces/s\n", urandom_rate / 1e6);
+    bench_report_add(&report, "nonce", "urandom", GFRX_NONCE_SIZE, 1, urandom_rate * GFRX_NONCE_SIZE * 8 / 1e6,
+                     1e6 / urandom_rate, urandom_iters);
+
+    cofb_nonce_gen_t gen;
+    byte_t nonces[64 * GFRX_NONCE_SIZE];
+    cofb_nonce_init(&gen);
+    start = wall_time();
+    for (int i = 0; i < NONCES_PER_THREAD / 64; i++) {
+        cofb_nonce_next_n(&gen, nonces, 64);
+    }
+    double batch_rate = (NONCES_PER_THREAD / 64) * 64 / (wall_time() - start);
+
+    for (unsigned t = 1; ; t *= 2) {
+        if (t > (unsigned)ncpu) t = (unsigned)ncpu;
+        double rate = benchmark_nonce_shared(t);
+        printf("  cofb_nonce_next, %2u threads:   %10.2f M nonces/s (%.0fx)\n", t, rate / 1e6, rate / urandom_rate);
+        bench_report_add(&report, "nonce", "cofb_nonce_next", GFRX_NONCE_SIZE, t, rate * GFRX_NONCE_SIZE * 8 / 1e6,
+                         1e6 / rate, (size_t)NONCES_PER_THREAD * t);
+        if (t == (unsigned)ncpu) break;
     }
+    printf("  cofb_nonce_next_n (64):        %10.2f M nonces/s\n", batch_rate / 1e6);
+    bench_report_add(&report, "nonce", "cofb_nonce_next_n", GFRX_NONCE_SIZE, 1,
+                     batch_rate * GFRX_NONCE_SIZE * 8 / 1e6, 1e6 / batch_rate, NONCES_PER_THREAD / 64 * 64);
 
-    return 0;
+    return bench_report_close(&report) == 0 ? 0 : 1;
 }
@@ -1,11 +1,20 @@
 /**
  * AEAD Comparison Benchmark
- * Compares GFRX+COFB vs GIFT-COFB vs ASCON-128 vs AES-128-GCM
+ * Compares GFRX+COFB vs GIFT-COFB vs ASCON-128 vs AES-128-GCM vs
+ * ChaCha20-Poly1305 vs AES-128-OCB
  *
  * Metrics measured:
  * - Throughput (Mbps) for different message sizes
  * - Latency (microseconds per operation)
  * - Memory footprint (state size in bits)
+ *
+ * Every scheme is one entry of AEADS[] (key setup, encrypt, decrypt, state
+ * size). Each is run over the whole size sweep twice: through its one-shot
+ * call, which sets the key up for every message, and through a key set up
+ * once and reused with fresh nonces. Adding a scheme means adding an entry.
+ *
+ * --json FILE / --csv FILE also write every result, with host metadata,
+ * for generate_graphs.py.
  */
 
 #define _POSIX_C_SOURCE 199309L
@@ -14,6 +23,8 @@
 #include "gift_cofb.h"
 #include "ascon.h"
 #include "aes_gcm.h"
+#include "openssl_aead.h"
+#include "bench_report.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,9 +35,17 @@
 #define MIN_ITERATIONS     1000
 #define MIN_TIME_SEC       1.0
 
-/* Test message sizes (in bytes) */
-static const size_t TEST_SIZES[] = {16, 64, 256, 1024, 4096, 16384};
-static const size_t NUM_SIZES = sizeof(TEST_SIZES) / sizeof(TEST_SIZES[0]);
+/* Size sweep: 16 B .. 16 KB in steps of 4x */
+#define SWEEP_MIN_SIZE     16
+#define SWEEP_MAX_SIZE     16384
+#define SWEEP_STEP         4
+
+/* Large message sizes (in bytes) for the scaling test: 64 KB .. 64 MB */
+static const size_t LARGE_SIZES[] = {
+    64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024
+};
+static const size_t NUM_LARGE_SIZES = sizeof(LARGE_SIZES) / sizeof(LARGE_SIZES[0]);
+#define LARGE_MIN_ITERATIONS  3
 
 /* Benchmark result structure */
 typedef struct {
@@ -35,172 +54,362 @@ typedef struct {
     size_t iterations;
 } benchmark_result_t;
 
-/* Results storage for analysis */
+/* Largest key, nonce and keyed state among the entries below */
+#define MAX_KEY_SIZE    32
+#define MAX_NONCE_SIZE  16
+
+/* GFRX+COFB (batch): messages per cofb_encrypt_batch() call */
+#define BENCH_BATCH         8
+/* GFRX+COFB (seg): segment size, small enough to split the larger sweep sizes */
+#define BENCH_SEGMENT_SIZE  4096
+
+typedef int (*aead_encrypt_fn)(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                               const byte_t *plaintext, size_t len, byte_t *ciphertext, byte_t *tag);
+typedef int (*aead_decrypt_fn)(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                               const byte_t *ciphertext, size_t len, const byte_t *tag, byte_t *plaintext);
+typedef int (*aead_oneshot_fn)(const byte_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                               const byte_t *plaintext, size_t len, byte_t *ciphertext, byte_t *tag);
+
+/* One AEAD scheme as seen by the benchmark */
 typedef struct {
-    benchmark_result_t gfrx[6];
-    benchmark_result_t gift[6];
-    benchmark_result_t ascon[6];
-    benchmark_result_t aes[6];
-} all_results_t;
+    const char *name;           /* table and report name; keyed rows add " (keyed)" */
+    const char *primitive;
+    unsigned state_bits;        /* working state, excluding the expanded key */
+    size_t key_size;
+    size_t nonce_size;
+    size_t ctx_size;            /* keyed state passed to the functions below */
+    int (*key_setup)(void *ctx, const byte_t *key);
+    void (*key_free)(void *ctx);            /* may be NULL */
+    aead_encrypt_fn encrypt;
+    aead_decrypt_fn decrypt;
+    aead_oneshot_fn encrypt_oneshot;        /* key setup included */
+    void (*select)(int active);             /* may be NULL; brackets the runs */
+    size_t msgs;                            /* messages per call, laid out back to back */
+    size_t (*ct_len)(size_t len);           /* may be NULL: ciphertext is len bytes */
+} aead_t;
+
+/* GFRX+COFB */
+static int gfrx_setup(void *ctx, const byte_t *key) {
+    return cofb_key_init(ctx, key);
+}
 
-/* Get current time in seconds */
-static double get_time(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec / 1e9;
+static int gfrx_enc(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                    const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    return cofb_encrypt_ctx(ctx, nonce, ad, ad_len, pt, len, ct, tag);
 }
 
-/* Benchmark GFRX+COFB encryption */
-static benchmark_result_t benchmark_gfrx_cofb(size_t msg_size) {
-    byte_t key[GFRX_KEY_SIZE] = {0};
-    byte_t nonce[GFRX_NONCE_SIZE] = {0};
-    byte_t *plaintext = malloc(msg_size);
-    byte_t *ciphertext = malloc(msg_size);
-    byte_t tag[GFRX_TAG_SIZE];
+static int gfrx_dec(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                    const byte_t *ct, size_t len, const byte_t *tag, byte_t *pt) {
+    return cofb_decrypt_ctx(ctx, nonce, ad, ad_len, ct, len, tag, pt);
+}
 
-    /* Initialize test data */
-    for (size_t i = 0; i < msg_size; i++) {
-        plaintext[i] = i & 0xFF;
+/*
+ * GFRX+COFB (batch): BENCH_BATCH messages of len bytes per call, all from the
+ * same plaintext, nonces differing in the last byte, ciphertexts and tags
+ * back to back.
+ */
+static void gfrx_batch_msgs(cofb_batch_msg_t *msgs, byte_t nonces[][GFRX_NONCE_SIZE],
+                            const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                            const byte_t *in, size_t in_stride, size_t len, byte_t *out, byte_t *tag) {
+    for (size_t i = 0; i < BENCH_BATCH; i++) {
+        memcpy(nonces[i], nonce, GFRX_NONCE_SIZE);
+        nonces[i][GFRX_NONCE_SIZE - 1] = (byte_t)i;
+        msgs[i].nonce = nonces[i];
+        msgs[i].ad = ad;
+        msgs[i].ad_len = ad_len;
+        msgs[i].in = in + i * in_stride;
+        msgs[i].in_len = len;
+        msgs[i].out = out + i * len;
+        msgs[i].tag = tag + i * GFRX_TAG_SIZE;
     }
+}
 
-    /* Warmup */
-    for (int i = 0; i < WARMUP_ITERATIONS; i++) {
-        nonce[0] = i & 0xFF;
-        cofb_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
-    }
+static int gfrx_batch_enc(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                          const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    cofb_batch_msg_t msgs[BENCH_BATCH];
+    byte_t nonces[BENCH_BATCH][GFRX_NONCE_SIZE];
 
-    /* Actual benchmark - run for at least MIN_TIME_SEC */
-    size_t iterations = 0;
-    double start_time = get_time();
-    double elapsed = 0.0;
+    gfrx_batch_msgs(msgs, nonces, nonce, ad, ad_len, pt, 0, len, ct, tag);
+    return cofb_encrypt_batch(ctx, msgs, BENCH_BATCH);
+}
 
-    while (elapsed < MIN_TIME_SEC || iterations < MIN_ITERATIONS) {
-        nonce[0] = iterations & 0xFF;
-        cofb_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
-        iterations++;
-        elapsed = get_time() - start_time;
+static int gfrx_batch_dec(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                          const byte_t *ct, size_t len, const byte_t *tag, byte_t *pt) {
+    cofb_batch_msg_t msgs[BENCH_BATCH];
+    byte_t nonces[BENCH_BATCH][GFRX_NONCE_SIZE];
+
+    gfrx_batch_msgs(msgs, nonces, nonce, ad, ad_len, ct, len, len, pt, (byte_t *)tag);
+    return cofb_decrypt_batch(ctx, msgs, BENCH_BATCH, NULL);
+}
+
+static int gfrx_batch_oneshot(const byte_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                              const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    cofb_key_t k;
+
+    if (cofb_key_init(&k, key) != GFRX_SUCCESS) {
+        return GFRX_ERR_INVALID;
     }
+    return gfrx_batch_enc(&k, nonce, ad, ad_len, pt, len, ct, tag);
+}
 
-    free(plaintext);
-    free(ciphertext);
+/* GFRX+COFB (seg): segment tags are inline in the ciphertext, tag is unused */
+static size_t gfrx_seg_len(size_t len) {
+    return cofb_segmented_len(len, BENCH_SEGMENT_SIZE);
+}
 
-    benchmark_result_t result;
-    result.iterations = iterations;
-    result.latency_us = (elapsed / iterations) * 1e6;
-    result.throughput_mbps = (iterations * msg_size * 8) / (elapsed * 1e6);
+static int gfrx_seg_enc(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                        const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    (void)tag;
+    return cofb_encrypt_segmented(ctx, nonce, ad, ad_len, pt, len, BENCH_SEGMENT_SIZE, ct, 0);
+}
 
-    return result;
+static int gfrx_seg_dec(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                        const byte_t *ct, size_t len, const byte_t *tag, byte_t *pt) {
+    (void)tag;
+    return cofb_decrypt_segmented(ctx, nonce, ad, ad_len, ct, gfrx_seg_len(len),
+                                  BENCH_SEGMENT_SIZE, pt, 0);
 }
 
-/* Benchmark GIFT-COFB encryption */
-static benchmark_result_t benchmark_gift_cofb(size_t msg_size) {
-    byte_t key[GIFT_KEY_SIZE] = {0};
-    byte_t nonce[GIFT_NONCE_SIZE] = {0};
-    byte_t *plaintext = malloc(msg_size);
-    byte_t *ciphertext = malloc(msg_size);
-    byte_t tag[GIFT_TAG_SIZE];
+static int gfrx_seg_oneshot(const byte_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                            const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    cofb_key_t k;
 
-    /* Initialize test data */
-    for (size_t i = 0; i < msg_size; i++) {
-        plaintext[i] = i & 0xFF;
+    if (cofb_key_init(&k, key) != GFRX_SUCCESS) {
+        return GFRX_ERR_INVALID;
     }
+    return gfrx_seg_enc(&k, nonce, ad, ad_len, pt, len, ct, tag);
+}
 
-    /* Warmup */
-    for (int i = 0; i < WARMUP_ITERATIONS; i++) {
-        nonce[0] = i & 0xFF;
-        gift_cofb_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
-    }
+/* GIFT-COFB, fixsliced or reference GIFT-128 */
+static int gift_setup(void *ctx, const byte_t *key) {
+    return gift_init(ctx, key);
+}
 
-    /* Actual benchmark */
-    size_t iterations = 0;
-    double start_time = get_time();
-    double elapsed = 0.0;
+static int gift_enc(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                    const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    return gift_cofb_encrypt_ctx(ctx, nonce, ad, ad_len, pt, len, ct, tag);
+}
 
-    while (elapsed < MIN_TIME_SEC || iterations < MIN_ITERATIONS) {
-        nonce[0] = iterations & 0xFF;
-        gift_cofb_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
-        iterations++;
-        elapsed = get_time() - start_time;
-    }
+static int gift_dec(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                    const byte_t *ct, size_t len, const byte_t *tag, byte_t *pt) {
+    return gift_cofb_decrypt_ctx(ctx, nonce, ad, ad_len, ct, len, tag, pt);
+}
 
-    free(plaintext);
-    free(ciphertext);
+static void gift_select_reference(int active) {
+    gift_set_backend(active ? "reference" : NULL);
+}
 
-    benchmark_result_t result;
-    result.iterations = iterations;
-    result.latency_us = (elapsed / iterations) * 1e6;
-    result.throughput_mbps = (iterations * msg_size * 8) / (elapsed * 1e6);
+/* ASCON-128 has no key schedule: the keyed state is the key itself */
+static int ascon_setup(void *ctx, const byte_t *key) {
+    memcpy(ctx, key, ASCON_KEY_SIZE);
+    return 0;
+}
 
-    return result;
+static int ascon_enc(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                     const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    return ascon_encrypt(ctx, nonce, ad, ad_len, pt, len, ct, tag);
 }
 
-/* Benchmark ASCON-128 encryption */
-static benchmark_result_t benchmark_ascon(size_t msg_size) {
-    byte_t key[ASCON_KEY_SIZE] = {0};
-    byte_t nonce[ASCON_NONCE_SIZE] = {0};
-    byte_t *plaintext = malloc(msg_size);
-    byte_t *ciphertext = malloc(msg_size);
-    byte_t tag[ASCON_TAG_SIZE];
+static int ascon_dec(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                     const byte_t *ct, size_t len, const byte_t *tag, byte_t *pt) {
+    return ascon_decrypt(ctx, nonce, ad, ad_len, ct, len, tag, pt);
+}
+
+/* AES-128-GCM (OpenSSL) */
+static int aes_gcm_setup(void *ctx, const byte_t *key) {
+    return aes_gcm_key_init(ctx, key);
+}
+
+static void aes_gcm_free(void *ctx) {
+    aes_gcm_key_free(ctx);
+}
+
+static int aes_gcm_enc(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                       const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    return aes_gcm_encrypt_ctx(ctx, nonce, ad, ad_len, pt, len, ct, tag);
+}
+
+static int aes_gcm_dec(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                       const byte_t *ct, size_t len, const byte_t *tag, byte_t *pt) {
+    return aes_gcm_decrypt_ctx(ctx, nonce, ad, ad_len, ct, len, tag, pt);
+}
+
+/* ChaCha20-Poly1305 and AES-128-OCB (OpenSSL) share the ossl_aead handle */
+static int ossl_setup(void *ctx, ossl_aead_alg_t alg, const byte_t *key) {
+    return ossl_aead_key_init(ctx, alg, key);
+}
+
+static int chacha_setup(void *ctx, const byte_t *key) {
+    return ossl_setup(ctx, OSSL_AEAD_CHACHA20_POLY1305, key);
+}
+
+static int ocb_setup(void *ctx, const byte_t *key) {
+    return ossl_setup(ctx, OSSL_AEAD_AES_128_OCB, key);
+}
+
+static void ossl_free(void *ctx) {
+    ossl_aead_key_free(ctx);
+}
+
+static int ossl_enc(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                    const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    return ossl_aead_encrypt_ctx(ctx, nonce, ad, ad_len, pt, len, ct, tag);
+}
+
+static int ossl_dec(void *ctx, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                    const byte_t *ct, size_t len, const byte_t *tag, byte_t *pt) {
+    return ossl_aead_decrypt_ctx(ctx, nonce, ad, ad_len, ct, len, tag, pt);
+}
+
+static int chacha_oneshot(const byte_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                          const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    return ossl_aead_encrypt(OSSL_AEAD_CHACHA20_POLY1305, key, nonce, ad, ad_len, pt, len, ct, tag);
+}
+
+static int ocb_oneshot(const byte_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                       const byte_t *pt, size_t len, byte_t *ct, byte_t *tag) {
+    return ossl_aead_encrypt(OSSL_AEAD_AES_128_OCB, key, nonce, ad, ad_len, pt, len, ct, tag);
+}
+
+static const aead_t AEADS[] = {
+    { "GFRX+COFB", "Feistel ARX", 320, GFRX_KEY_SIZE, GFRX_NONCE_SIZE, sizeof(cofb_key_t),
+      gfrx_setup, NULL, gfrx_enc, gfrx_dec, cofb_encrypt, NULL, 1, NULL },
+    { "GFRX+COFB (batch)", "Feistel ARX, batched", 320 * BENCH_BATCH, GFRX_KEY_SIZE, GFRX_NONCE_SIZE,
+      sizeof(cofb_key_t), gfrx_setup, NULL, gfrx_batch_enc, gfrx_batch_dec, gfrx_batch_oneshot, NULL,
+      BENCH_BATCH, NULL },
+    { "GFRX+COFB (seg)", "Feistel ARX, segmented", 320, GFRX_KEY_SIZE, GFRX_NONCE_SIZE, sizeof(cofb_key_t),
+      gfrx_setup, NULL, gfrx_seg_enc, gfrx_seg_dec, gfrx_seg_oneshot, NULL, 1, gfrx_seg_len },
+    { "GIFT-COFB", "SPN (GIFT-128)", 320, GIFT_KEY_SIZE, GIFT_NONCE_SIZE, sizeof(gift_ctx_t),
+      gift_setup, NULL, gift_enc, gift_dec, gift_cofb_encrypt, NULL, 1, NULL },
+    { "GIFT-COFB (ref)", "SPN (GIFT-128), bitwise", 320, GIFT_KEY_SIZE, GIFT_NONCE_SIZE, sizeof(gift_ctx_t),
+      gift_setup, NULL, gift_enc, gift_dec, gift_cofb_encrypt, gift_select_reference, 1, NULL },
+    { "ASCON-128", "Sponge permutation", 320, ASCON_KEY_SIZE, ASCON_NONCE_SIZE, ASCON_KEY_SIZE,
+      ascon_setup, NULL, ascon_enc, ascon_dec, ascon_encrypt, NULL, 1, NULL },
+    { "AES-128-GCM", "SPN (AES-128)", 384, AES_KEY_SIZE, AES_NONCE_SIZE, sizeof(aes_gcm_key_t),
+      aes_gcm_setup, aes_gcm_free, aes_gcm_enc, aes_gcm_dec, aes_gcm_encrypt, NULL, 1, NULL },
+    { "ChaCha20-Poly1305", "ARX stream + MAC", 770, 32, 12, sizeof(ossl_aead_key_t),
+      chacha_setup, ossl_free, ossl_enc, ossl_dec, chacha_oneshot, NULL, 1, NULL },
+    { "AES-128-OCB", "SPN (AES-128)", 384, 16, 12, sizeof(ossl_aead_key_t),
+      ocb_setup, ossl_free, ossl_enc, ossl_dec, ocb_oneshot, NULL, 1, NULL },
+};
+
+#define NUM_AEADS (sizeof(AEADS) / sizeof(AEADS[0]))
+
+/* Get current time in seconds */
+static double get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Decrypt what encrypt produced and compare, so a broken adapter cannot post a number */
+static void verify_aead(const aead_t *a, void *ctx, const byte_t *nonce, const byte_t *plaintext,
+                        size_t msg_size, byte_t *ciphertext, byte_t *tag) {
+    byte_t *decrypted = malloc(a->msgs * msg_size + 1);
+
+    if (a->encrypt(ctx, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag) != 0 ||
+        a->decrypt(ctx, nonce, NULL, 0, ciphertext, msg_size, tag, decrypted) != 0) {
+        fprintf(stderr, "Error: %s round trip failed at %zu bytes\n", a->name, msg_size);
+        exit(1);
+    }
+    for (size_t i = 0; i < a->msgs; i++) {
+        if (memcmp(decrypted + i * msg_size, plaintext, msg_size) != 0) {
+            fprintf(stderr, "Error: %s decrypts to the wrong plaintext at %zu bytes\n", a->name, msg_size);
+            exit(1);
+        }
+    }
+    free(decrypted);
+}
+
+/*
+ * Benchmark one scheme at one size, with per-message key setup or a reused
+ * key. The keyed run first checks a round trip through decrypt.
+ */
+static benchmark_result_t benchmark_aead(const aead_t *a, size_t msg_size, int keyed) {
+    byte_t key[MAX_KEY_SIZE] = {0};
+    byte_t nonce[MAX_NONCE_SIZE] = {0};
+    size_t ct_len = a->ct_len != NULL ? a->ct_len(msg_size) : msg_size;
+    byte_t *plaintext = malloc(msg_size + 1);
+    byte_t *ciphertext = malloc(a->msgs * ct_len + 1);
+    byte_t *tag = malloc(a->msgs * 16);
+    void *ctx = keyed ? calloc(1, a->ctx_size) : NULL;
 
     for (size_t i = 0; i < msg_size; i++) {
         plaintext[i] = i & 0xFF;
     }
+    if (keyed && a->key_setup(ctx, key) != 0) {
+        fprintf(stderr, "Error: key setup failed for %s\n", a->name);
+        exit(1);
+    }
+    if (keyed) {
+        verify_aead(a, ctx, nonce, plaintext, msg_size, ciphertext, tag);
+    }
 
     /* Warmup */
     for (int i = 0; i < WARMUP_ITERATIONS; i++) {
         nonce[0] = i & 0xFF;
-        ascon_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
+        if (keyed) {
+            a->encrypt(ctx, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
+        } else {
+            a->encrypt_oneshot(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
+        }
     }
 
-    /* Actual benchmark */
+    /* Actual benchmark - run for at least MIN_TIME_SEC */
     size_t iterations = 0;
     double start_time = get_time();
     double elapsed = 0.0;
 
     while (elapsed < MIN_TIME_SEC || iterations < MIN_ITERATIONS) {
         nonce[0] = iterations & 0xFF;
-        ascon_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
+        if (keyed) {
+            a->encrypt(ctx, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
+        } else {
+            a->encrypt_oneshot(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
+        }
         iterations++;
         elapsed = get_time() - start_time;
     }
 
+    if (keyed && a->key_free != NULL) {
+        a->key_free(ctx);
+    }
+    free(ctx);
     free(plaintext);
     free(ciphertext);
+    free(tag);
 
+    /* Per message: a batch call counts as a->msgs messages */
     benchmark_result_t result;
-    result.iterations = iterations;
-    result.latency_us = (elapsed / iterations) * 1e6;
-    result.throughput_mbps = (iterations * msg_size * 8) / (elapsed * 1e6);
+    result.iterations = iterations * a->msgs;
+    result.latency_us = (elapsed / result.iterations) * 1e6;
+    result.throughput_mbps = (result.iterations * msg_size * 8) / (elapsed * 1e6);
 
     return result;
 }
 
-/* Benchmark AES-128-GCM encryption */
-static benchmark_result_t benchmark_aes_gcm(size_t msg_size) {
-    byte_t key[AES_KEY_SIZE] = {0};
-    byte_t nonce[AES_NONCE_SIZE] = {0};
+/* Benchmark GFRX+COFB encryption on large messages (few iterations, no warmup loop) */
+static benchmark_result_t benchmark_gfrx_cofb_large(size_t msg_size) {
+    byte_t key[GFRX_KEY_SIZE] = {0};
+    byte_t nonce[GFRX_NONCE_SIZE] = {0};
     byte_t *plaintext = malloc(msg_size);
     byte_t *ciphertext = malloc(msg_size);
-    byte_t tag[AES_TAG_SIZE];
+    byte_t tag[GFRX_TAG_SIZE];
 
     for (size_t i = 0; i < msg_size; i++) {
         plaintext[i] = i & 0xFF;
     }
 
-    /* Warmup */
-    for (int i = 0; i < WARMUP_ITERATIONS; i++) {
-        nonce[0] = i & 0xFF;
-        aes_gcm_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
-    }
+    /* Single warmup pass touches every page of both buffers */
+    cofb_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
 
-    /* Actual benchmark */
     size_t iterations = 0;
     double start_time = get_time();
     double elapsed = 0.0;
 
-    while (elapsed < MIN_TIME_SEC || iterations < MIN_ITERATIONS) {
+    while (elapsed < MIN_TIME_SEC || iterations < LARGE_MIN_ITERATIONS) {
         nonce[0] = iterations & 0xFF;
-        aes_gcm_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
+        cofb_encrypt(key, nonce, NULL, 0, plaintext, msg_size, ciphertext, tag);
         iterations++;
         elapsed = get_time() - start_time;
     }
@@ -220,75 +429,118 @@ static benchmark_result_t benchmark_aes_gcm(size_t msg_size) {
 static void print_header(void) {
     printf("\n");
     printf("===============================================================================\n");
-    printf("  AEAD Performance Comparison: GFRX+COFB vs GIFT-COFB vs ASCON vs AES-GCM\n");
+    printf("  AEAD Performance Comparison: GFRX+COFB vs GIFT-COFB vs ASCON vs AES and ChaCha\n");
     printf("===============================================================================\n");
     printf("\n");
 }
 
+static void print_bits(unsigned bits, const char *suffix) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u bits", bits);
+    printf("%-10s%s", buf, suffix);
+}
+
 /* Print characteristics table */
 static void print_characteristics(void) {
     printf("Algorithm Characteristics:\n");
     printf("-------------------------------------------------------------------------------\n");
-    printf("Scheme          State     Key       Nonce     Primitive Type\n");
+    printf("Scheme             State     Key       Nonce     Primitive Type\n");
     printf("-------------------------------------------------------------------------------\n");
-    printf("GFRX+COFB       320 bits  128 bits   64 bits  Feistel ARX\n");
-    printf("GIFT-COFB       320 bits  128 bits   64 bits  SPN (GIFT-128)\n");
-    printf("ASCON-128       320 bits  128 bits  128 bits  Sponge permutation\n");
-    printf("AES-128-GCM     384 bits  128 bits   96 bits  SPN (AES-128)\n");
+    for (size_t i = 0; i < NUM_AEADS; i++) {
+        const aead_t *a = &AEADS[i];
+        printf("%-19s", a->name);
+        print_bits(a->state_bits, "");
+        print_bits((unsigned)(a->key_size * 8), "");
+        print_bits((unsigned)(a->nonce_size * 8), "");
+        printf("%s\n", a->primitive);
+    }
     printf("-------------------------------------------------------------------------------\n");
     printf("\n");
 }
 
-/* Print comparison table for a specific size */
-static void print_comparison(size_t msg_size,
-                            benchmark_result_t gfrx,
-                            benchmark_result_t gift,
-                            benchmark_result_t ascon,
-                            benchmark_result_t aes) {
-    printf("Message Size: %zu bytes\n", msg_size);
+static void print_table_header(void) {
+    printf("Encryption, no associated data. \"Per message\": the one-shot call, key set up\n");
+    printf("for every message. \"Keyed\": key set up once, only the nonce changes.\n");
+    printf("Batch rows run %d messages per call; latency is per message.\n", BENCH_BATCH);
     printf("-------------------------------------------------------------------------------\n");
-    printf("Scheme           Throughput (Mbps)  Latency (us)   Iterations\n");
+    printf("                              Per message              Keyed\n");
+    printf("Size (B)  Scheme              Mbps       Latency (us)  Mbps       Latency (us)\n");
     printf("-------------------------------------------------------------------------------\n");
-    printf("GFRX+COFB        %17.2f  %12.3f  %11zu\n",
-           gfrx.throughput_mbps, gfrx.latency_us, gfrx.iterations);
-    printf("GIFT-COFB        %17.2f  %12.3f  %11zu\n",
-           gift.throughput_mbps, gift.latency_us, gift.iterations);
-    printf("ASCON-128        %17.2f  %12.3f  %11zu\n",
-           ascon.throughput_mbps, ascon.latency_us, ascon.iterations);
-    printf("AES-128-GCM      %17.2f  %12.3f  %11zu\n",
-           aes.throughput_mbps, aes.latency_us, aes.iterations);
-    printf("-------------------------------------------------------------------------------\n");
-    printf("\n");
 }
 
-/* Print benchmark completion */
-static void print_summary(const all_results_t *results) {
-    (void)results;  /* Unused */
-    printf("Benchmark completed.\n");
+static void print_row(size_t msg_size, const aead_t *a, benchmark_result_t once, benchmark_result_t keyed) {
+    printf("%8zu  %-18s  %9.2f  %12.3f  %9.2f  %12.3f\n", msg_size, a->name,
+           once.throughput_mbps, once.latency_us, keyed.throughput_mbps, keyed.latency_us);
+}
+
+/* Record one encrypt result in the --json/--csv report */
+static void report_result(bench_report_t *report, const char *scheme, size_t msg_size,
+                          benchmark_result_t r) {
+    bench_report_add(report, "encrypt", scheme, msg_size, 1, r.throughput_mbps, r.latency_us, r.iterations);
+}
+
+/* Print large-message scaling table for GFRX+COFB */
+static void print_large_scaling(bench_report_t *report) {
+    printf("GFRX+COFB Large Message Scaling (throughput should stay flat)\n");
+    printf("-------------------------------------------------------------------------------\n");
+    printf("Message Size     Throughput (Mbps)  Latency (ms)   Iterations\n");
+    printf("-------------------------------------------------------------------------------\n");
+    for (size_t i = 0; i < NUM_LARGE_SIZES; i++) {
+        size_t size = LARGE_SIZES[i];
+        benchmark_result_t r = benchmark_gfrx_cofb_large(size);
+        printf("%8zu KB      %17.2f  %12.3f  %11zu\n",
+               size / 1024, r.throughput_mbps, r.latency_us / 1000.0, r.iterations);
+        bench_report_add(report, "encrypt_large", "GFRX+COFB", size, 1,
+                         r.throughput_mbps, r.latency_us, r.iterations);
+    }
+    printf("-------------------------------------------------------------------------------\n");
+    printf("\n");
 }
 
 /* Main benchmark function */
-int main(void) {
-    all_results_t results;
+int main(int argc, char *argv[]) {
+    bench_report_t report;
+
+    if (bench_report_open_args(&report, "comparison_benchmark", argc, argv) != 0) {
+        return 1;
+    }
 
     print_header();
     print_characteristics();
 
     printf("Running benchmarks (each test runs for minimum %.1f second)...\n\n", MIN_TIME_SEC);
-
-    for (size_t i = 0; i < NUM_SIZES; i++) {
-        size_t size = TEST_SIZES[i];
-
-        results.gfrx[i] = benchmark_gfrx_cofb(size);
-        results.gift[i] = benchmark_gift_cofb(size);
-        results.ascon[i] = benchmark_ascon(size);
-        results.aes[i] = benchmark_aes_gcm(size);
-
-        print_comparison(size, results.gfrx[i], results.gift[i],
-                        results.ascon[i], results.aes[i]);
+    print_table_header();
+
+    for (size_t size = SWEEP_MIN_SIZE; size <= SWEEP_MAX_SIZE; size *= SWEEP_STEP) {
+        for (size_t i = 0; i < NUM_AEADS; i++) {
+            const aead_t *a = &AEADS[i];
+            char keyed_name[64];
+
+            if (a->select != NULL) {
+                a->select(1);
+            }
+            benchmark_result_t once = benchmark_aead(a, size, 0);
+            benchmark_result_t keyed = benchmark_aead(a, size, 1);
+            if (a->select != NULL) {
+                a->select(0);
+            }
+
+            print_row(size, a, once, keyed);
+            snprintf(keyed_name, sizeof(keyed_name), "%s (keyed)", a->name);
+            report_result(&report, a->name, size, once);
+            report_result(&report, keyed_name, size, keyed);
+        }
+        if (size * SWEEP_STEP <= SWEEP_MAX_SIZE) {
+            printf("\n");
+        }
+        fflush(stdout);
     }
+    printf("-------------------------------------------------------------------------------\n");
+    printf("\n");
 
-    print_summary(&results);
+    print_large_scaling(&report);
 
-    return 0;
+    printf("Benchmark completed.\n");
+
+    return bench_report_close(&report) == 0 ? 0 : 1;
 }
@@ -0,0 +1,166 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "include/gfrx_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * gfrx_engine scaling: a fixed mixed workload (telemetry frames, medium
+ * records and multi-megabyte firmware images) run on 1..N worker threads.
+ */
+
+#define NUM_FRAMES      20000
+#define FRAME_SIZE      16
+#define NUM_RECORDS     500
+#define RECORD_SIZE     4096
+#define NUM_IMAGES      4
+#define IMAGE_SIZE      (10 * 1024 * 1024)
+
+typedef struct {
+    gfrx_job_t *jobs;
+    size_t njobs;
+    byte_t *in;
+    byte_t *out;
+    byte_t *tags;
+    byte_t *nonces;
+    size_t total_bytes;
+} workload_t;
+
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Frames, records and images in a fixed random order, so large jobs land between small ones. */
+static int workload_init(workload_t *w, const cofb_key_t *key) {
+    size_t in_size = (size_t)NUM_FRAMES * FRAME_SIZE + (size_t)NUM_RECORDS * RECORD_SIZE +
+                     (size_t)NUM_IMAGES * IMAGE_SIZE;
+    size_t out_size = (size_t)NUM_FRAMES * FRAME_SIZE + (size_t)NUM_RECORDS * RECORD_SIZE +
+                      NUM_IMAGES * cofb_segmented_len(IMAGE_SIZE, COFB_SEGMENT_SIZE_DEFAULT);
+
+    w->njobs = NUM_FRAMES + NUM_RECORDS + NUM_IMAGES;
+    w->jobs = calloc(w->njobs, sizeof(*w->jobs));
+    w->in = malloc(in_size);
+    w->out = malloc(out_size);
+    w->tags = malloc(w->njobs * GFRX_TAG_SIZE);
+    w->nonces = malloc(w->njobs * GFRX_NONCE_SIZE);
+    if (!w->jobs || !w->in || !w->out || !w->tags || !w->nonces) {
+        return -1;
+    }
+    for (size_t i = 0; i < in_size; i++) w->in[i] = i & 0xFF;
+
+    /* Shuffle the job sizes with a fixed LCG so the order is the same every run. */
+    size_t *sizes = malloc(w->njobs * sizeof(*sizes));
+    if (!sizes) {
+        return -1;
+    }
+    for (size_t j = 0; j < w->njobs; j++) {
+        sizes[j] = j < NUM_IMAGES ? IMAGE_SIZE : j < NUM_IMAGES + NUM_RECORDS ? RECORD_SIZE : FRAME_SIZE;
+    }
+    uint32_t seed = 12345;
+    for (size_t j = w->njobs - 1; j > 0; j--) {
+        seed = seed * 1103515245u + 12345u;
+        size_t k = (seed >> 8) % (j + 1);
+        size_t tmp = sizes[j];
+        sizes[j] = sizes[k];
+        sizes[k] = tmp;
+    }
+
+    size_t in_off = 0, out_off = 0;
+    w->total_bytes = in_size;
+    for (size_t j = 0; j < w->njobs; j++) {
+        gfrx_job_t *job = &w->jobs[j];
+        size_t len = sizes[j];
+        if (len == IMAGE_SIZE) {
+            job->segment_size = COFB_SEGMENT_SIZE_DEFAULT;
+        }
+
+        for (int i = 0; i < GFRX_NONCE_SIZE; i++) w->nonces[j * GFRX_NONCE_SIZE + i] = (j >> (8 * i)) & 0xFF;
+        job->op = GFRX_JOB_ENCRYPT;
+        job->key = key;
+        job->nonce = w->nonces + j * GFRX_NONCE_SIZE;
+        job->in = w->in + in_off;
+        job->in_len = len;
+        job->out = w->out + out_off;
+        job->tag = w->tags + j * GFRX_TAG_SIZE;
+
+        in_off += len;
+        out_off += job->segment_size ? cofb_segmented_len(len, job->segment_size) : len;
+    }
+    free(sizes);
+    return 0;
+}
+
+static void workload_free(workload_t *w) {
+    free(w->jobs);
+    free(w->in);
+    free(w->out);
+    free(w->tags);
+    free(w->nonces);
+}
+
+static double run_workload(gfrx_engine_t *engine, workload_t *w) {
+    double start = wall_time();
+    for (size_t j = 0; j < w->njobs; j++) {
+        gfrx_engine_submit(engine, &w->jobs[j]);
+    }
+    size_t completed = 0;
+    while (gfrx_engine_wait(engine) != NULL) {
+        completed++;
+    }
+    double end = wall_time();
+
+    if (completed != w->njobs) {
+        fprintf(stderr, "engine: %zu of %zu jobs completed\n", completed, w->njobs);
+    }
+    return end - start;
+}
+
+int main(int argc, char *argv[]) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned max_threads = (argc > 1) ? (unsigned)atoi(argv[1]) : (unsigned)(ncpu > 0 ? ncpu : 1);
+    if (max_threads == 0) max_threads = 1;
+
+    byte_t key_bytes[GFRX_KEY_SIZE];
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key_bytes[i] = i;
+    cofb_key_t key;
+    cofb_key_init(&key, key_bytes);
+
+    workload_t w;
+    if (workload_init(&w, &key) != 0) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    printf("GFRX Engine Scaling Benchmark\n\n");
+    printf("Workload: %d x %d B frames, %d x %d B records, %d x %d MB images (segmented)\n",
+           NUM_FRAMES, FRAME_SIZE, NUM_RECORDS, RECORD_SIZE, NUM_IMAGES, IMAGE_SIZE >> 20);
+    printf("Online CPUs: %ld, dispatch backend: %s\n\n", ncpu, gfrx_backend_name());
+
+    double base = 0;
+    for (unsigned t = 1; ; t *= 2) {
+        if (t > max_threads) t = max_threads;
+
+        gfrx_engine_t *engine = gfrx_engine_create(t);
+        if (engine == NULL) {
+            fprintf(stderr, "Cannot start %u threads\n", t);
+            break;
+        }
+        run_workload(engine, &w);      /* warm-up */
+        double time = run_workload(engine, &w);
+        gfrx_engine_destroy(engine);
+
+        if (t == 1) base = time;
+        printf("  %2u threads: %8.2f MB/s, %9.0f jobs/s (%.2fx)\n", t,
+               w.total_bytes / time / (1024.0 * 1024.0), w.njobs / time, base / time);
+        if (t == max_threads) break;
+    }
+
+    secure_zero(&key, sizeof(key));
+    workload_free(&w);
+    return 0;
+}
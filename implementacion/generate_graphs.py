@@ -3,10 +3,24 @@
 Generate performance graphs for GFRX+COFB thesis
 Author: Fernando Ramirez Arredondo
 Date: 2025-11-18
+
+Reads the result files written by the benchmarks and overlays every run given:
+
+    ./bin/comparison_benchmark --json maquina_a.json
+    ./bin/benchmark --csv gfrx_a.csv
+    python3 generate_graphs.py maquina_a.json maquina_b.csv gfrx_a.csv
+
+resultados/comparacion_tesis.csv holds the numbers of COMPARACION_RESULTADOS.md.
 """
 
-import matplotlib.pyplot as plt
+import argparse
+import csv
+import json
+import os
+import sys
+
 import matplotlib
+import matplotlib.pyplot as plt
 import numpy as np
 
 # Use non-interactive backend
@@ -20,36 +34,153 @@ plt.rcParams['axes.labelsize'] = 12
 plt.rcParams['axes.titlesize'] = 14
 plt.rcParams['legend.fontsize'] = 10
 
-# Performance data from COMPARACION_RESULTADOS.md
-message_sizes = [16, 64, 256, 1024, 4096, 16384]  # bytes
-
-# Throughput data (Mbps)
-throughput_gfrx = [289.11, 616.90, 889.27, 871.33, 552.84, 220.91]
-throughput_ascon = [191.01, 394.10, 532.51, 594.57, 611.32, 600.81]
-throughput_aes_gcm = [112.16, 506.48, 1864.40, 7116.39, 23811.68, 54902.33]
-
-# Latency data (microseconds)
-latency_gfrx = [0.443, 0.830, 2.303, 9.402, 59.272, 593.337]
-latency_ascon = [0.670, 1.299, 3.846, 13.778, 53.602, 218.159]
-latency_aes_gcm = [1.141, 1.011, 1.098, 1.151, 1.376, 2.387]
+# Marker and color per scheme; unknown schemes fall back to matplotlib's cycle
+SCHEME_STYLE = {
+    'GFRX+COFB': ('o', '#2E86AB'),
+    'GFRX+COFB (batch)': ('<', '#2E86AB'),
+    'GFRX+COFB (seg)': ('>', '#2E86AB'),
+    'GIFT-COFB': ('D', '#3B8B5A'),
+    'ASCON-128': ('s', '#A23B72'),
+    'AES-128-GCM': ('^', '#F18F01'),
+    'ChaCha20-Poly1305': ('v', '#6C4AB6'),
+    'AES-128-OCB': ('P', '#C73E1D'),
+}
+
+# State size in bits, for the efficiency graph
+STATE_BITS = {
+    'GFRX+COFB': 320,
+    'GFRX+COFB (batch)': 2560,
+    'GFRX+COFB (seg)': 320,
+    'GIFT-COFB': 320,
+    'ASCON-128': 320,
+    'AES-128-GCM': 384,
+    'ChaCha20-Poly1305': 770,
+    'AES-128-OCB': 384,
+}
+
+# One line style / hatch per run when several runs are overlaid
+RUN_LINESTYLES = ['-', '--', ':', '-.']
+RUN_HATCHES = ['', '//', '..', 'xx', '\\\\']
+
+NUMERIC_FIELDS = {'bytes': int, 'threads': int, 'throughput_mbps': float,
+                  'latency_us': float, 'iterations': int}
+
+
+def load_run(path):
+    """Load one --json or --csv result file into {'label', 'host', 'results'}"""
+    with open(path, newline='') as f:
+        if path.endswith('.json'):
+            data = json.load(f)
+            host, results = data.get('host', {}), data.get('results', [])
+        else:
+            host, rows = {}, []
+            for line in f:
+                if line.startswith('#'):
+                    key, _, value = line[1:].partition(':')
+                    host[key.strip()] = value.strip()
+                else:
+                    rows.append(line)
+            results = list(csv.DictReader(rows))
+
+    for r in results:
+        for field, conv in NUMERIC_FIELDS.items():
+            r[field] = conv(r[field]) if r.get(field) not in (None, '') else None
+
+    label = os.path.splitext(os.path.basename(path))[0]
+    return {'label': label, 'host': host, 'results': results}
+
+
+def series(run, test, scheme):
+    """(sizes, throughput, latency) of one scheme in one run, sorted by size"""
+    rows = sorted((r for r in run['results']
+                   if r['test'] == test and r['scheme'] == scheme and r['threads'] == 1),
+                  key=lambda r: r['bytes'])
+    return ([r['bytes'] for r in rows], [r['throughput_mbps'] for r in rows],
+            [r['latency_us'] for r in rows])
+
+
+def value_at(run, test, scheme, size, field='throughput_mbps'):
+    for r in run['results']:
+        if r['test'] == test and r['scheme'] == scheme and r['bytes'] == size and r['threads'] == 1:
+            return r[field]
+    return None
+
+
+def schemes_of(runs, test):
+    """Schemes present in any run, in SCHEME_STYLE order first"""
+    seen = []
+    for run in runs:
+        for r in run['results']:
+            if r['test'] == test and r['scheme'] not in seen:
+                seen.append(r['scheme'])
+    known = [s for s in SCHEME_STYLE if s in seen]
+    return known + [s for s in seen if s not in known]
+
+
+def sizes_of(runs, test):
+    return sorted({r['bytes'] for run in runs for r in run['results'] if r['test'] == test})
+
+
+def style(scheme):
+    return SCHEME_STYLE.get(scheme, ('o', None))
+
+
+def series_label(scheme, run, runs):
+    return scheme if len(runs) == 1 else f'{scheme} [{run["label"]}]'
+
+
+def describe_runs(runs):
+    """Host line for each run, printed and used as figure footnote"""
+    lines = []
+    for run in runs:
+        h = run['host']
+        lines.append(f'{run["label"]}: {h.get("cpu", "?")}, {h.get("compiler", "?")} '
+                     f'{h.get("cflags", "")}, backend {h.get("backend", "?")}')
+    return '\n'.join(lines)
+
+
+def footnote(fig, runs):
+    fig.text(0.01, -0.02, describe_runs(runs), fontsize=7, ha='left', va='top', style='italic')
+
+
+def grouped_bars(ax, runs, schemes, sizes, field):
+    """One bar per (run, scheme) at each size; returns the bar containers"""
+    pairs = [(run, scheme) for run in runs for scheme in schemes]
+    x = np.arange(len(sizes))
+    width = 0.8 / len(pairs)
+    containers = []
+    for k, (run, scheme) in enumerate(pairs):
+        values = [value_at(run, 'encrypt', scheme, s, field) or 0 for s in sizes]
+        _, color = style(scheme)
+        offset = (k - (len(pairs) - 1) / 2) * width
+        bars = ax.bar(x + offset, values, width, label=series_label(scheme, run, runs),
+                      color=color, alpha=0.8, edgecolor='black',
+                      hatch=RUN_HATCHES[runs.index(run) % len(RUN_HATCHES)])
+        containers.append(bars)
+    ax.set_xticks(x)
+    ax.set_xticklabels(sizes)
+    return containers
 
 
-def generate_throughput_graph():
+def generate_throughput_graph(runs):
     """Generate throughput vs message size comparison graph"""
     fig, ax = plt.subplots()
-
-    # Plot lines
-    ax.plot(message_sizes, throughput_gfrx, 'o-', linewidth=2, markersize=8,
-            label='GFRX+COFB', color='#2E86AB')
-    ax.plot(message_sizes, throughput_ascon, 's-', linewidth=2, markersize=8,
-            label='ASCON-128', color='#A23B72')
-    ax.plot(message_sizes, throughput_aes_gcm, '^-', linewidth=2, markersize=8,
-            label='AES-128-GCM', color='#F18F01')
+    schemes = schemes_of(runs, 'encrypt')
+
+    # Plot lines: color per scheme, line style per run
+    for i, run in enumerate(runs):
+        for scheme in schemes:
+            sizes, mbps, _ = series(run, 'encrypt', scheme)
+            if not sizes:
+                continue
+            marker, color = style(scheme)
+            ax.plot(sizes, mbps, marker=marker, linestyle=RUN_LINESTYLES[i % len(RUN_LINESTYLES)],
+                    linewidth=2, markersize=8, label=series_label(scheme, run, runs), color=color)
 
     # Labels and title
     ax.set_xlabel('Tamaño de Mensaje (bytes)', fontweight='bold')
     ax.set_ylabel('Throughput (Mbps)', fontweight='bold')
-    ax.set_title('Comparación de Throughput: GFRX+COFB vs ASCON vs AES-GCM',
+    ax.set_title('Comparación de Throughput: ' + ' vs '.join(schemes),
                  fontweight='bold', pad=20)
 
     # Log scale for x-axis (message sizes vary widely)
@@ -62,51 +193,38 @@ def generate_throughput_graph():
     # Legend
     ax.legend(loc='best', framealpha=0.9)
 
-    # Annotations for key points
-    # GFRX+COFB wins at 16 bytes
-    ax.annotate('GFRX+COFB\nmejor (289 Mbps)',
-                xy=(16, 289.11), xytext=(20, 400),
-                arrowprops=dict(arrowstyle='->', color='#2E86AB', lw=1.5),
-                fontsize=9, ha='left', color='#2E86AB', fontweight='bold')
-
-    # AES-GCM dominates at 16KB
-    ax.annotate('AES-GCM\ndomina (55 Gbps)',
-                xy=(16384, 54902.33), xytext=(10000, 30000),
-                arrowprops=dict(arrowstyle='->', color='#F18F01', lw=1.5),
-                fontsize=9, ha='center', color='#F18F01', fontweight='bold')
-
+    # Annotate the fastest scheme at the smallest and largest size (single run only)
+    if len(runs) == 1:
+        sizes = sizes_of(runs, 'encrypt')
+        for size, text, offset in ((sizes[0], 'mejor', (1.25, 1.4)), (sizes[-1], 'domina', (0.6, 0.55))):
+            best = max(schemes, key=lambda s: value_at(runs[0], 'encrypt', s, size) or 0)
+            mbps = value_at(runs[0], 'encrypt', best, size)
+            _, color = style(best)
+            ax.annotate(f'{best}\n{text} ({mbps:,.0f} Mbps)',
+                        xy=(size, mbps), xytext=(size * offset[0], mbps * offset[1]),
+                        arrowprops=dict(arrowstyle='->', color=color, lw=1.5),
+                        fontsize=9, ha='center', color=color, fontweight='bold')
+
+    footnote(fig, runs)
     plt.tight_layout()
     plt.savefig('throughput_comparison.png', dpi=300, bbox_inches='tight')
     print("✓ Generated: throughput_comparison.png")
     plt.close()
 
 
-def generate_latency_graph():
+def generate_latency_graph(runs):
     """Generate latency comparison bar chart"""
     fig, ax = plt.subplots()
 
     # Select specific message sizes for clarity (not all)
-    selected_sizes = [16, 64, 256, 1024]
-    selected_indices = [0, 1, 2, 3]
-
-    x = np.arange(len(selected_sizes))
-    width = 0.25
-
-    # Create bars
-    bars1 = ax.bar(x - width, [latency_gfrx[i] for i in selected_indices],
-                   width, label='GFRX+COFB', color='#2E86AB', alpha=0.8)
-    bars2 = ax.bar(x, [latency_ascon[i] for i in selected_indices],
-                   width, label='ASCON-128', color='#A23B72', alpha=0.8)
-    bars3 = ax.bar(x + width, [latency_aes_gcm[i] for i in selected_indices],
-                   width, label='AES-128-GCM', color='#F18F01', alpha=0.8)
+    selected_sizes = [s for s in sizes_of(runs, 'encrypt') if s <= 1024]
+    bars = grouped_bars(ax, runs, schemes_of(runs, 'encrypt'), selected_sizes, 'latency_us')
 
     # Labels
     ax.set_xlabel('Tamaño de Mensaje (bytes)', fontweight='bold')
     ax.set_ylabel('Latencia (microsegundos)', fontweight='bold')
     ax.set_title('Comparación de Latencia para Mensajes Pequeños (IoT)',
                  fontweight='bold', pad=20)
-    ax.set_xticks(x)
-    ax.set_xticklabels(selected_sizes)
 
     # Grid
     ax.grid(True, alpha=0.3, linestyle='--', axis='y')
@@ -124,36 +242,36 @@ def generate_latency_graph():
                        textcoords="offset points",
                        ha='center', va='bottom', fontsize=8)
 
-    autolabel(bars1)
-    autolabel(bars2)
-    autolabel(bars3)
+    for b in bars:
+        autolabel(b)
 
+    footnote(fig, runs)
     plt.tight_layout()
     plt.savefig('latency_comparison.png', dpi=300, bbox_inches='tight')
     print("✓ Generated: latency_comparison.png")
     plt.close()
 
 
-def generate_efficiency_graph():
+def generate_efficiency_graph(runs):
     """Generate efficiency metrics (Mbps per byte of state)"""
     fig, ax = plt.subplots()
 
-    # State sizes (bits -> bytes)
-    state_gfrx = 320 / 8  # 40 bytes
-    state_ascon = 320 / 8  # 40 bytes
-    state_aes_gcm = 384 / 8  # 48 bytes
-
-    # Calculate efficiency for 256-byte messages (typical IoT)
-    idx_256 = 2  # index for 256 bytes
-    efficiency_gfrx = throughput_gfrx[idx_256] / state_gfrx
-    efficiency_ascon = throughput_ascon[idx_256] / state_ascon
-    efficiency_aes_gcm = throughput_aes_gcm[idx_256] / state_aes_gcm
-
-    schemes = ['GFRX+COFB', 'ASCON-128', 'AES-128-GCM']
-    efficiency = [efficiency_gfrx, efficiency_ascon, efficiency_aes_gcm]
-    colors = ['#2E86AB', '#A23B72', '#F18F01']
-
-    bars = ax.bar(schemes, efficiency, color=colors, alpha=0.8, edgecolor='black', linewidth=1.5)
+    # Efficiency for 256-byte messages (typical IoT)
+    names, efficiency, colors, hatches, states = [], [], [], [], []
+    for i, run in enumerate(runs):
+        for scheme in schemes_of(runs, 'encrypt'):
+            mbps = value_at(run, 'encrypt', scheme, 256)
+            if mbps is None or scheme not in STATE_BITS:
+                continue
+            names.append(series_label(scheme, run, runs).replace(' [', '\n['))
+            efficiency.append(mbps / (STATE_BITS[scheme] / 8))
+            colors.append(style(scheme)[1])
+            hatches.append(RUN_HATCHES[i % len(RUN_HATCHES)])
+            states.append(STATE_BITS[scheme])
+
+    bars = ax.bar(names, efficiency, color=colors, alpha=0.8, edgecolor='black', linewidth=1.5)
+    for bar, hatch in zip(bars, hatches):
+        bar.set_hatch(hatch)
 
     # Labels
     ax.set_ylabel('Eficiencia (Mbps / byte de estado)', fontweight='bold')
@@ -171,83 +289,79 @@ def generate_efficiency_graph():
                 ha='center', va='bottom', fontweight='bold', fontsize=11)
 
     # Add state size annotations
-    state_sizes = [state_gfrx, state_ascon, state_aes_gcm]
-    for i, (bar, state) in enumerate(zip(bars, state_sizes)):
+    for bar, state in zip(bars, states):
         ax.text(bar.get_x() + bar.get_width()/2., 5,
-                f'Estado: {int(state*8)} bits',
+                f'Estado: {state} bits',
                 ha='center', va='bottom', fontsize=9, style='italic')
 
+    footnote(fig, runs)
     plt.tight_layout()
     plt.savefig('efficiency_comparison.png', dpi=300, bbox_inches='tight')
     print("✓ Generated: efficiency_comparison.png")
     plt.close()
 
 
-def generate_small_message_focus():
+def generate_small_message_focus(runs):
     """Generate graph focusing on small messages (IoT sweet spot)"""
     fig, ax = plt.subplots()
 
     # Focus on 16-256 bytes (typical IoT)
-    small_sizes = message_sizes[:3]
-    small_gfrx = throughput_gfrx[:3]
-    small_ascon = throughput_ascon[:3]
-    small_aes_gcm = throughput_aes_gcm[:3]
-
-    x = np.arange(len(small_sizes))
-    width = 0.25
-
-    bars1 = ax.bar(x - width, small_gfrx, width, label='GFRX+COFB',
-                   color='#2E86AB', alpha=0.8, edgecolor='black')
-    bars2 = ax.bar(x, small_ascon, width, label='ASCON-128',
-                   color='#A23B72', alpha=0.8, edgecolor='black')
-    bars3 = ax.bar(x + width, small_aes_gcm, width, label='AES-128-GCM',
-                   color='#F18F01', alpha=0.8, edgecolor='black')
+    small_sizes = [s for s in sizes_of(runs, 'encrypt') if s <= 256]
+    schemes = schemes_of(runs, 'encrypt')
+    grouped_bars(ax, runs, schemes, small_sizes, 'throughput_mbps')
 
     ax.set_xlabel('Tamaño de Mensaje (bytes)', fontweight='bold')
     ax.set_ylabel('Throughput (Mbps)', fontweight='bold')
     ax.set_title('Rendimiento en Mensajes Pequeños (Escenario IoT)',
                  fontweight='bold', pad=20)
-    ax.set_xticks(x)
-    ax.set_xticklabels(small_sizes)
 
     ax.grid(True, alpha=0.3, linestyle='--', axis='y')
     ax.legend(loc='upper left', framealpha=0.9)
 
-    # Add advantage annotations
-    ax.text(0, small_gfrx[0] + 30, '1.5x más\nrápido', ha='center',
-            fontsize=9, color='#2E86AB', fontweight='bold')
-
+    # Advantage of GFRX+COFB over the next scheme at the smallest size (single run only)
+    if len(runs) == 1 and small_sizes and 'GFRX+COFB' in schemes:
+        size = small_sizes[0]
+        ours = value_at(runs[0], 'encrypt', 'GFRX+COFB', size)
+        others = [(value_at(runs[0], 'encrypt', s, size), s) for s in schemes if s != 'GFRX+COFB']
+        others = [o for o in others if o[0]]
+        if ours and others:
+            rival, name = max(others)
+            ratio = ours / rival
+            ax.text(0, ours * 1.05, f'{ratio:.1f}x vs\n{name}', ha='center',
+                    fontsize=9, color=SCHEME_STYLE['GFRX+COFB'][1], fontweight='bold')
+
+    footnote(fig, runs)
     plt.tight_layout()
     plt.savefig('small_message_performance.png', dpi=300, bbox_inches='tight')
     print("✓ Generated: small_message_performance.png")
     plt.close()
 
 
-def generate_summary_table_image():
+def generate_summary_table_image(runs):
     """Generate a summary table as an image"""
     fig, ax = plt.subplots(figsize=(12, 6))
     ax.axis('tight')
     ax.axis('off')
 
-    # Data for table
-    table_data = [
-        ['Esquema', 'Estado\n(bits)', '16 bytes\n(Mbps)', '64 bytes\n(Mbps)',
-         '256 bytes\n(Mbps)', '1 KB\n(Mbps)', 'Mejor para'],
-        ['GFRX+COFB', '320', '289', '617', '889', '871',
-         'IoT, mensajes\npequeños'],
-        ['ASCON-128', '320', '191', '394', '533', '595',
-         'Balance\ngeneral'],
-        ['AES-128-GCM', '384', '112', '506', '1,864', '7,116',
-         'Mensajes\ngrandes']
-    ]
-
-    # Each row has 7 columns
-    num_cols = 7
-    colors = [['#E8E8E8']*num_cols,  # Header
-              ['#D6EAF8']*num_cols,  # GFRX (light blue)
-              ['#F5CED4']*num_cols,  # ASCON (light purple)
-              ['#FCE8D1']*num_cols]  # AES-GCM (light orange)
-
+    sizes = [s for s in sizes_of(runs, 'encrypt') if s <= 1024]
+    size_names = [f'{s // 1024} KB' if s >= 1024 else f'{s} bytes' for s in sizes]
+
+    # Data for table: one row per scheme and run
+    table_data = [['Esquema', 'Ejecución', 'Estado\n(bits)'] +
+                  [f'{name}\n(Mbps)' for name in size_names]]
+    colors = [['#E8E8E8'] * len(table_data[0])]
+    for run in runs:
+        for scheme in schemes_of(runs, 'encrypt'):
+            values = [value_at(run, 'encrypt', scheme, s) for s in sizes]
+            if all(v is None for v in values):
+                continue
+            table_data.append([scheme, run['label'], str(STATE_BITS.get(scheme, '?'))] +
+                              ['-' if v is None else f'{v:,.0f}' for v in values])
+            # Light tint of the scheme color
+            color = matplotlib.colors.to_rgb(style(scheme)[1] or '#888888')
+            colors.append([tuple(0.75 + 0.25 * c for c in color)] * len(table_data[0]))
+
+    num_cols = len(table_data[0])
     table = ax.table(cellText=table_data, cellLoc='center', loc='center',
                      cellColours=colors, bbox=[0, 0, 1, 1])
 
@@ -259,7 +373,7 @@ def generate_summary_table_image():
     for i in range(num_cols):
         table[(0, i)].set_text_props(weight='bold', fontsize=11)
 
-    plt.title('Resumen de Rendimiento: GFRX+COFB vs ASCON vs AES-GCM',
+    plt.title('Resumen de Rendimiento: ' + ' vs '.join(schemes_of(runs, 'encrypt')),
               fontweight='bold', fontsize=14, pad=20)
 
     plt.savefig('performance_summary_table.png', dpi=300, bbox_inches='tight')
@@ -267,35 +381,81 @@ def generate_summary_table_image():
     plt.close()
 
 
+def generate_gfrx_runs_graph(runs):
+    """Overlay COFB encrypt/decrypt throughput from ./bin/benchmark runs"""
+    fig, ax = plt.subplots()
+
+    for i, run in enumerate(runs):
+        for test, marker, color in (('cofb_encrypt', 'o', '#2E86AB'), ('cofb_decrypt', 's', '#5FA8D3')):
+            sizes, mbps, _ = series(run, test, 'GFRX+COFB')
+            if not sizes:
+                continue
+            label = test if len(runs) == 1 else f'{test} [{run["label"]}]'
+            ax.plot(sizes, mbps, marker=marker, linestyle=RUN_LINESTYLES[i % len(RUN_LINESTYLES)],
+                    linewidth=2, markersize=8, label=label, color=color)
+
+    ax.set_xlabel('Tamaño de Mensaje (bytes)', fontweight='bold')
+    ax.set_ylabel('Throughput (Mbps)', fontweight='bold')
+    ax.set_title('GFRX+COFB: comparación entre ejecuciones', fontweight='bold', pad=20)
+    ax.set_xscale('log')
+    ax.grid(True, alpha=0.3, linestyle='--')
+    ax.legend(loc='best', framealpha=0.9)
+
+    footnote(fig, runs)
+    plt.tight_layout()
+    plt.savefig('gfrx_cofb_runs.png', dpi=300, bbox_inches='tight')
+    print("✓ Generated: gfrx_cofb_runs.png")
+    plt.close()
+
+
 def main():
     """Generate all graphs"""
+    parser = argparse.ArgumentParser(description='Graphs from benchmark --json/--csv results')
+    parser.add_argument('files', nargs='+', help='result files (.json or .csv); several runs are overlaid')
+    args = parser.parse_args()
+
     print("\n" + "="*60)
     print("Generating Performance Graphs for GFRX+COFB Thesis")
     print("="*60 + "\n")
 
     try:
-        generate_throughput_graph()
-        generate_latency_graph()
-        generate_efficiency_graph()
-        generate_small_message_focus()
-        generate_summary_table_image()
+        runs = [load_run(path) for path in args.files]
+        comparison = [r for r in runs if any(x['test'] == 'encrypt' for x in r['results'])]
+        gfrx = [r for r in runs if any(x['test'] == 'cofb_encrypt' for x in r['results'])]
+        print(describe_runs(runs) + "\n")
+
+        generated = []
+        if comparison:
+            generate_throughput_graph(comparison)
+            generate_latency_graph(comparison)
+            generate_efficiency_graph(comparison)
+            generate_small_message_focus(comparison)
+            generate_summary_table_image(comparison)
+            generated += ['throughput_comparison.png', 'latency_comparison.png',
+                          'efficiency_comparison.png', 'small_message_performance.png',
+                          'performance_summary_table.png']
+        if gfrx:
+            generate_gfrx_runs_graph(gfrx)
+            generated.append('gfrx_cofb_runs.png')
+        if not generated:
+            print("✗ No comparison_benchmark or benchmark results in the given files")
+            return 1
 
         print("\n" + "="*60)
         print("✓ All graphs generated successfully!")
         print("="*60)
         print("\nGenerated files:")
-        print("  1. throughput_comparison.png")
-        print("  2. latency_comparison.png")
-        print("  3. efficiency_comparison.png")
-        print("  4. small_message_performance.png")
-        print("  5. performance_summary_table.png")
+        for i, name in enumerate(generated, 1):
+            print(f"  {i}. {name}")
         print("\nThese can be included in the thesis chapters.")
 
     except Exception as e:
         print(f"\n✗ Error generating graphs: {e}")
         import traceback
         traceback.print_exc()
+        return 1
+    return 0
 
 
 if __name__ == "__main__":
-    main()
+    sys.exit(main())
@@ -1,32 +1,72 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "include/gfrx_cofb.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
-static void generate_random_nonce(byte_t *nonce, size_t len) {
-    FILE *f = fopen("/dev/urandom", "rb");
-    if (f) {
-        fread(nonce, 1, len, f);
-        fclose(f);
-    } else {
-        srand(time(NULL));
-        for (size_t i = 0; i < len; i++) {
-            nonce[i] = rand() & 0xFF;
-        }
-    }
-}
+/*
+ * Streaming format (default):
+ *   "GFRX" | version (1) | 0 | ad_len (u16 LE) | segment_size (u32 LE) | ad | nonce
+ *   followed by the cofb_encrypt_segmented() layout: C_0 || T_0 || ... || C_last || T_last
+ * Every segment is verified before its plaintext is written, so memory stays
+ * at a few buffers whatever the file size, and input/output may be pipes.
+ * Segment i (chunk i) starts at a fixed offset after the header, so the chunk
+ * index is implicit and decrypt --range reads only the chunks it needs.
+ * By default reading, crypto and writing run as a three-thread pipeline.
+ * With --mmap both files are mapped and the whole layout is produced in
+ * place by cofb_encrypt_segmented()/cofb_decrypt_segmented(); the bytes are
+ * the same as in streaming mode.
+ *
+ * Legacy format (--legacy): ad_len (u16) | ad | nonce | tag | ciphertext,
+ * one COFB message over the whole file, read and written in memory.
+ */
+
+#define STREAM_MAGIC        "GFRX"
+#define STREAM_VERSION      1
+#define STREAM_HEADER_SIZE  12
+#define STREAM_SEGMENTS     16      /* segments per read/write buffer */
+/*
+ * Largest segment_size accepted from a header. Buffers are sized from it
+ * before any tag is checked, so a crafted header must not be able to ask
+ * for more; the writer always emits COFB_SEGMENT_SIZE_DEFAULT.
+ */
+#define STREAM_MAX_SEGMENT  (4 * COFB_SEGMENT_SIZE_DEFAULT)
+
+/* Seeded once in main(); shared by the encrypt-dir workers. */
+static cofb_nonce_gen_t nonce_gen;
 
 static void print_usage(const char *prog) {
-    printf("Usage: %s <command> <input> <key_hex> [ad_string]\n\n", prog);
+    printf("Usage: %s <command> <input> <key_hex> [ad_string] [options]\n\n", prog);
     printf("Commands:\n");
-    printf("  encrypt    Cifrar archivo\n");
-    printf("  decrypt    Descifrar archivo\n\n");
+    printf("  encrypt      Cifrar archivo\n");
+    printf("  decrypt      Descifrar archivo\n");
+    printf("  encrypt-dir  Cifrar cada archivo de un directorio (o de una lista) a <archivo>.enc\n");
+    printf("  verify       Verificar los tags de un archivo, o de los .enc de un directorio, sin descifrar\n\n");
+    printf("Options:\n");
+    printf("  -o <file>  Output file ('-' = stdout; default <input>.enc / <input>.dec)\n");
+    printf("  --legacy   Encrypt in the old single-tag format (whole file in memory)\n");
+    printf("  --range <off>:<len>  Decrypt only plaintext bytes [off, off+len) (input must be a file)\n");
+    printf("  --serial   Read, process and write in one thread (default: 3-stage pipeline)\n");
+    printf("  --mmap     Map input and output files and process them in place (no copies)\n");
+    printf("  --stats    Print per-stage throughput (read / crypto / write)\n");
+    printf("  --manifest encrypt-dir/verify: <input> is a file with one path per line ('-' = stdin)\n");
+    printf("  -j <n>     encrypt-dir/verify: worker threads (default: one per CPU)\n\n");
+    printf("Input '-' reads stdin (output then defaults to stdout).\n");
     printf("Key format: 32 hex chars (128 bits)\n");
     printf("AD (optional): Associated Data (authenticated but not encrypted)\n\n");
     printf("Examples:\n");
     printf("  %s encrypt file.txt 0123456789abcdef0123456789abcdef\n", prog);
     printf("  %s encrypt file.txt 0123456789abcdef0123456789abcdef \"user:alice,file:secret.txt\"\n", prog);
+    printf("  tar c dir | %s encrypt - 0123456789abcdef0123456789abcdef > dir.tar.enc\n", prog);
 }
 
 static int hex_to_bytes(const char *hex, byte_t *bytes, size_t len) {
@@ -82,126 +122,1288 @@ static int write_file(const char *filename, const byte_t *data, size_t size) {
     return 0;
 }
 
-int main(int argc, char *argv[]) {
-    if (argc < 4 || argc > 5) {
-        print_usage(argv[0]);
-        return 1;
+/* fread() until len bytes or end of input; short only at EOF or on error. */
+static size_t read_full(FILE *f, byte_t *buf, size_t len) {
+    size_t total = 0;
+    while (total < len) {
+        size_t n = fread(buf + total, 1, len - total, f);
+        if (n == 0) {
+            break;
+        }
+        total += n;
     }
+    return total;
+}
 
-    const char *command = argv[1];
-    const char *input_file = argv[2];
-    const char *key_hex = argv[3];
-    const char *ad_string = (argc == 5) ? argv[4] : NULL;
+static void store16_le(byte_t *p, uint16_t v) {
+    p[0] = (byte_t)v;
+    p[1] = (byte_t)(v >> 8);
+}
 
-    byte_t *ad = NULL;
-    size_t ad_len = 0;
-    if (ad_string) {
-        ad = (byte_t *)ad_string;
-        ad_len = strlen(ad_string);
+static void store32_le(byte_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (byte_t)(v >> (8 * i));
+}
+
+static uint32_t load32_le(const byte_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int is_stdio(const char *path) {
+    return strcmp(path, "-") == 0;
+}
+
+static FILE *open_input(const char *path) {
+    FILE *f = is_stdio(path) ? stdin : fopen(path, "rb");
+    if (!f) {
+        perror("Error opening file");
     }
+    return f;
+}
 
-    byte_t key[GFRX_KEY_SIZE];
-    if (hex_to_bytes(key_hex, key, GFRX_KEY_SIZE) != 0) {
-        fprintf(stderr, "Error: Invalid key format (need 32 hex chars)\n");
-        return 1;
+static FILE *open_output(const char *path) {
+    FILE *f = is_stdio(path) ? stdout : fopen(path, "wb");
+    if (!f) {
+        perror("Error creating output file");
     }
+    return f;
+}
 
-    if (strcmp(command, "encrypt") == 0) {
-        size_t plaintext_len;
-        byte_t *plaintext = read_file(input_file, &plaintext_len);
-        if (!plaintext) return 1;
+static void close_stream(FILE *f) {
+    if (f != stdin && f != stdout) {
+        fclose(f);
+    }
+}
 
-        byte_t nonce[GFRX_NONCE_SIZE];
-        generate_random_nonce(nonce, GFRX_NONCE_SIZE);
+typedef struct {
+    const cofb_key_t *key;
+    byte_t nonce[GFRX_NONCE_SIZE];
+    const byte_t *ad;
+    size_t ad_len;
+    size_t seg;
+    int decrypt;
+    uint64_t index;         /* next segment number */
+    unsigned nthreads;      /* threads per buffer, 0 = one per CPU */
+} stream_ctx_t;
 
-        byte_t *ciphertext = malloc(plaintext_len);
-        byte_t tag[GFRX_TAG_SIZE];
+typedef struct {
+    double read_time, crypto_time, write_time, wall_time;
+    unsigned long long read_bytes, write_bytes;
+} stream_stats_t;
 
-        if (cofb_encrypt(key, nonce, ad, ad_len, plaintext, plaintext_len,
-                        ciphertext, tag) != GFRX_SUCCESS) {
-            fprintf(stderr, "Error: Encryption failed\n");
-            free(plaintext);
-            free(ciphertext);
-            return 1;
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static size_t stream_in_cap(const stream_ctx_t *c) {
+    return STREAM_SEGMENTS * (c->decrypt ? c->seg + GFRX_TAG_SIZE : c->seg);
+}
+
+static size_t stream_out_cap(const stream_ctx_t *c) {
+    return STREAM_SEGMENTS * (c->seg + GFRX_TAG_SIZE);
+}
+
+/*
+ * Encrypts or decrypts one buffer of whole segments, spread over c->nthreads
+ * threads; last marks the buffer holding the final segment. Returns 0, -1 if
+ * the input is malformed or -2 if a segment fails authentication.
+ */
+static int process_chunk(stream_ctx_t *c, const byte_t *in, size_t n, int last,
+                         byte_t *out, size_t *out_len) {
+    size_t segments;
+    size_t pt_len;
+
+    *out_len = 0;
+    if (!c->decrypt) {
+        segments = cofb_segment_count(n, c->seg);
+        if (cofb_encrypt_segments(c->key, c->nonce, c->ad, c->ad_len, c->index, last,
+                                  in, n, c->seg, out, c->nthreads) != GFRX_SUCCESS) {
+            return -1;
         }
+        *out_len = cofb_segmented_len(n, c->seg);
+        c->index += segments;
+        return 0;
+    }
 
-        char output_file[256];
-        snprintf(output_file, sizeof(output_file), "%s.enc", input_file);
+    if (cofb_segmented_layout(n, c->seg, &segments, &pt_len) != GFRX_SUCCESS) {
+        return -1;
+    }
+    int ret = cofb_decrypt_segments(c->key, c->nonce, c->ad, c->ad_len, c->index, last,
+                                    in, n, c->seg, out, c->nthreads);
+    if (ret != GFRX_SUCCESS) {
+        return ret == GFRX_ERR_AUTH ? -2 : -1;
+    }
+    *out_len = pt_len;
+    c->index += segments;
+    return 0;
+}
 
-        FILE *f = fopen(output_file, "wb");
-        if (!f) {
-            perror("Error creating output file");
-            free(plaintext);
-            free(ciphertext);
-            return 1;
+/*
+ * One thread: read (with one buffer of lookahead to find the last segment),
+ * process, write. With out == NULL a decrypt only checks the tags and no
+ * output buffer exists.
+ */
+static int run_serial(FILE *in, FILE *out, stream_ctx_t *c, stream_stats_t *st) {
+    const size_t cap = stream_in_cap(c);
+    byte_t *cur = malloc(cap);
+    byte_t *next = malloc(cap);
+    byte_t *obuf = out ? malloc(stream_out_cap(c)) : NULL;
+    size_t used = 0;        /* high-water mark of obuf, wiped at the end */
+    int ret = 0;
+    double t;
+
+    if (!cur || !next || (out && !obuf)) {
+        ret = -1;
+        goto done;
+    }
+
+    t = now();
+    size_t n = read_full(in, cur, cap);
+    st->read_time += now() - t;
+    for (;;) {
+        t = now();
+        size_t n_next = (n == cap) ? read_full(in, next, cap) : 0;
+        st->read_time += now() - t;
+        st->read_bytes += n;
+        int last = (n_next == 0);
+
+        size_t out_len;
+        t = now();
+        ret = process_chunk(c, cur, n, last, obuf, &out_len);
+        st->crypto_time += now() - t;
+        if (ret != 0) {
+            break;
+        }
+        if (out_len > used) {
+            used = out_len;
         }
 
-        uint16_t ad_len_u16 = (uint16_t)ad_len;
-        fwrite(&ad_len_u16, sizeof(uint16_t), 1, f);
-        if (ad_len > 0) {
-            fwrite(ad, 1, ad_len, f);
+        t = now();
+        if (out && fwrite(obuf, 1, out_len, out) != out_len) {
+            ret = -1;
+            break;
         }
-        fwrite(nonce, 1, GFRX_NONCE_SIZE, f);
-        fwrite(tag, 1, GFRX_TAG_SIZE, f);
-        fwrite(ciphertext, 1, plaintext_len, f);
-        fclose(f);
+        st->write_time += now() - t;
+        st->write_bytes += out_len;
+        if (last) {
+            break;
+        }
+        byte_t *tmp = cur;
+        cur = next;
+        next = tmp;
+        n = n_next;
+    }
+
+done:
+    if (obuf) {
+        secure_zero(obuf, used);
+    }
+    free(cur);
+    free(next);
+    free(obuf);
+    return ret;
+}
+
+/*
+ * Three stages over a ring of PIPE_SLOTS buffers: a reader thread fills
+ * slots, this thread encrypts/decrypts them in order, and a writer thread
+ * drains them, so I/O overlaps with crypto. Slot k holds chunk k; read,
+ * processed and written count the chunks that passed each stage.
+ */
+#define PIPE_SLOTS 4
+
+typedef struct {
+    byte_t *in;
+    byte_t *out;
+    size_t n;
+    size_t out_len;
+    size_t used;            /* high-water mark of out, wiped at the end */
+    int last;
+} pipe_slot_t;
+
+typedef struct {
+    pipe_slot_t slots[PIPE_SLOTS];
+    size_t cap;
+    FILE *in;
+    FILE *out;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    size_t read;
+    size_t processed;
+    size_t written;
+    int abort;
+    int io_error;
+    stream_stats_t *st;
+} pipeline_t;
+
+/* Waits until chunk k may be read into its slot, i.e. chunk k - PIPE_SLOTS has been written. */
+static int pipe_wait_free(pipeline_t *p, size_t k) {
+    pthread_mutex_lock(&p->lock);
+    while (k - p->written >= PIPE_SLOTS && !p->abort) {
+        pthread_cond_wait(&p->cond, &p->lock);
+    }
+    int ok = !p->abort;
+    pthread_mutex_unlock(&p->lock);
+    return ok;
+}
+
+static void pipe_advance(pipeline_t *p, size_t *counter, size_t value) {
+    pthread_mutex_lock(&p->lock);
+    *counter = value;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void pipe_abort(pipeline_t *p) {
+    pthread_mutex_lock(&p->lock);
+    p->abort = 1;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void *pipe_reader(void *arg) {
+    pipeline_t *p = arg;
+    size_t k = 0;
+    double t;
+
+    if (!pipe_wait_free(p, 0)) {
+        return NULL;
+    }
+    t = now();
+    size_t n = read_full(p->in, p->slots[0].in, p->cap);
+    p->st->read_time += now() - t;
+
+    /* Chunk k is published only once chunk k + 1 has been read, to know whether k is the last. */
+    for (;;) {
+        pipe_slot_t *slot = &p->slots[k % PIPE_SLOTS];
+        size_t n_next = 0;
+        if (n == p->cap) {
+            if (!pipe_wait_free(p, k + 1)) {
+                return NULL;
+            }
+            t = now();
+            n_next = read_full(p->in, p->slots[(k + 1) % PIPE_SLOTS].in, p->cap);
+            p->st->read_time += now() - t;
+        }
+        slot->n = n;
+        slot->last = (n_next == 0);
+        p->st->read_bytes += n;
+        if (slot->last && ferror(p->in)) {
+            p->io_error = 1;
+            pipe_abort(p);
+            return NULL;
+        }
+        pipe_advance(p, &p->read, k + 1);
+        if (slot->last) {
+            return NULL;
+        }
+        n = n_next;
+        k++;
+    }
+}
+
+static void *pipe_writer(void *arg) {
+    pipeline_t *p = arg;
+
+    for (size_t k = 0; ; k++) {
+        pthread_mutex_lock(&p->lock);
+        while (p->processed <= k && !p->abort) {
+            pthread_cond_wait(&p->cond, &p->lock);
+        }
+        int stop = (p->processed <= k);
+        pthread_mutex_unlock(&p->lock);
+        if (stop) {
+            return NULL;
+        }
+
+        pipe_slot_t *slot = &p->slots[k % PIPE_SLOTS];
+        double t = now();
+        if (fwrite(slot->out, 1, slot->out_len, p->out) != slot->out_len) {
+            p->io_error = 1;
+            pipe_abort(p);
+            return NULL;
+        }
+        p->st->write_time += now() - t;
+        p->st->write_bytes += slot->out_len;
+        int last = slot->last;
+        pipe_advance(p, &p->written, k + 1);
+        if (last) {
+            return NULL;
+        }
+    }
+}
+
+static int run_pipeline(FILE *in, FILE *out, stream_ctx_t *c, stream_stats_t *st) {
+    pipeline_t p;
+    pthread_t reader, writer;
+    int ret = 0;
+
+    memset(&p, 0, sizeof(p));
+    p.cap = stream_in_cap(c);
+    p.in = in;
+    p.out = out;
+    p.st = st;
+    for (int i = 0; i < PIPE_SLOTS; i++) {
+        p.slots[i].in = malloc(p.cap);
+        p.slots[i].out = malloc(stream_out_cap(c));
+        if (!p.slots[i].in || !p.slots[i].out) {
+            ret = -1;
+        }
+    }
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.cond, NULL);
+
+    if (ret == 0 && pthread_create(&reader, NULL, pipe_reader, &p) != 0) {
+        ret = -1;
+    } else if (ret == 0 && pthread_create(&writer, NULL, pipe_writer, &p) != 0) {
+        pipe_abort(&p);
+        pthread_join(reader, NULL);
+        ret = -1;
+    } else if (ret == 0) {
+        for (size_t k = 0; ; k++) {
+            pthread_mutex_lock(&p.lock);
+            while (p.read <= k && !p.abort) {
+                pthread_cond_wait(&p.cond, &p.lock);
+            }
+            int stop = (p.read <= k);
+            pthread_mutex_unlock(&p.lock);
+            if (stop) {
+                ret = -1;
+                break;
+            }
+
+            pipe_slot_t *slot = &p.slots[k % PIPE_SLOTS];
+            double t = now();
+            ret = process_chunk(c, slot->in, slot->n, slot->last, slot->out, &slot->out_len);
+            st->crypto_time += now() - t;
+            if (ret != 0) {
+                pipe_abort(&p);
+                break;
+            }
+            if (slot->out_len > slot->used) {
+                slot->used = slot->out_len;
+            }
+            /* The slot may be refilled as soon as it is handed on; read last first. */
+            int last = slot->last;
+            pipe_advance(&p, &p.processed, k + 1);
+            if (last) {
+                break;
+            }
+        }
+        pthread_join(reader, NULL);
+        pthread_join(writer, NULL);
+        if (p.io_error) {
+            ret = -1;
+        }
+    }
 
-        printf("Encrypted: %s -> %s\n", input_file, output_file);
-        if (ad_len > 0) {
-            printf("AD: %s\n", ad_string);
+    for (int i = 0; i < PIPE_SLOTS; i++) {
+        if (p.slots[i].out) {
+            secure_zero(p.slots[i].out, p.slots[i].used);
         }
-        printf("Size: %zu bytes\n", plaintext_len);
+        free(p.slots[i].in);
+        free(p.slots[i].out);
+    }
+    pthread_cond_destroy(&p.cond);
+    pthread_mutex_destroy(&p.lock);
+    return ret;
+}
+
+static int run_stream(FILE *in, FILE *out, stream_ctx_t *c, int pipelined, stream_stats_t *st) {
+    double t = now();
+    int ret = pipelined ? run_pipeline(in, out, c, st) : run_serial(in, out, c, st);
+    if (ret == 0 && (ferror(in) || fflush(out) != 0)) {
+        ret = -1;
+    }
+    st->wall_time = now() - t;
+    return ret;
+}
+
+static void print_stats(FILE *f, const stream_stats_t *st, const char *mode) {
+    double mb_in = st->read_bytes / (1024.0 * 1024.0);
+    double mb_out = st->write_bytes / (1024.0 * 1024.0);
+
+    fprintf(f, "Stats (%s):\n", mode);
+    fprintf(f, "  read:   %9.2f MB in %7.3f s (%8.2f MB/s)\n", mb_in, st->read_time,
+            st->read_time > 0 ? mb_in / st->read_time : 0);
+    fprintf(f, "  crypto: %9.2f MB in %7.3f s (%8.2f MB/s)\n", mb_in, st->crypto_time,
+            st->crypto_time > 0 ? mb_in / st->crypto_time : 0);
+    fprintf(f, "  write:  %9.2f MB in %7.3f s (%8.2f MB/s)\n", mb_out, st->write_time,
+            st->write_time > 0 ? mb_out / st->write_time : 0);
+    fprintf(f, "  wall:   %7.3f s (%.2f MB/s), stage sum %.3f s\n", st->wall_time,
+            st->wall_time > 0 ? mb_in / st->wall_time : 0,
+            st->read_time + st->crypto_time + st->write_time);
+}
+
+/* Encrypts in to out in the streaming format; returns the plaintext size or -1. */
+static long long encrypt_stream(FILE *in, FILE *out, const cofb_key_t *key,
+                                const byte_t *ad, size_t ad_len, int pipelined, stream_stats_t *st) {
+    stream_ctx_t c = { key, {0}, ad, ad_len, COFB_SEGMENT_SIZE_DEFAULT, 0, 0, pipelined ? 0 : 1 };
+    byte_t header[STREAM_HEADER_SIZE];
+
+    if (ad_len > 0xFFFF) {
+        fprintf(stderr, "Error: AD too long (max 65535 bytes)\n");
+        return -1;
+    }
+    cofb_nonce_next(&nonce_gen, c.nonce);
+
+    memcpy(header, STREAM_MAGIC, 4);
+    header[4] = STREAM_VERSION;
+    header[5] = 0;
+    store16_le(header + 6, (uint16_t)ad_len);
+    store32_le(header + 8, (uint32_t)c.seg);
+    if (fwrite(header, 1, sizeof(header), out) != sizeof(header) ||
+        (ad_len > 0 && fwrite(ad, 1, ad_len, out) != ad_len) ||
+        fwrite(c.nonce, 1, GFRX_NONCE_SIZE, out) != GFRX_NONCE_SIZE) {
+        return -1;
+    }
+
+    if (run_stream(in, out, &c, pipelined, st) != 0) {
+        return -1;
+    }
+    return (long long)st->read_bytes;
+}
+
+/* Reads the AD and nonce following a streaming header into c; -1 if the header is invalid. */
+static int read_stream_header(FILE *in, const byte_t *header, stream_ctx_t *c, byte_t *ad, size_t *ad_len) {
+    *ad_len = (size_t)header[6] | ((size_t)header[7] << 8);
+    c->ad = ad;
+    c->ad_len = *ad_len;
+    c->seg = load32_le(header + 8);
+    c->decrypt = 1;
+    if (header[4] != STREAM_VERSION || c->seg == 0 || c->seg > STREAM_MAX_SEGMENT ||
+        read_full(in, ad, *ad_len) != *ad_len ||
+        read_full(in, c->nonce, GFRX_NONCE_SIZE) != GFRX_NONCE_SIZE) {
+        fprintf(stderr, "Error: File corrupted (invalid header)\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* Decrypts the streaming format after its header; returns the plaintext size, -1 on error, -2 on auth failure. */
+static long long decrypt_stream(FILE *in, FILE *out, const cofb_key_t *key, const byte_t *header,
+                                byte_t *ad, size_t *ad_len, int pipelined, stream_stats_t *st) {
+    stream_ctx_t c = { key, {0}, ad, 0, 0, 1, 0, pipelined ? 0 : 1 };
+
+    if (read_stream_header(in, header, &c, ad, ad_len) != 0) {
+        return -1;
+    }
+
+    int ret = run_stream(in, out, &c, pipelined, st);
+    if (ret == -1 && !ferror(in) && !ferror(out)) {
+        fprintf(stderr, "Error: File corrupted (truncated segment)\n");
+    }
+    return ret == 0 ? (long long)st->write_bytes : ret;
+}
+
+static int parse_range(const char *arg, unsigned long long *off, unsigned long long *len) {
+    char *end;
+    errno = 0;
+    *off = strtoull(arg, &end, 0);
+    if (end == arg || *end != ':' || arg[0] == '-') {
+        return -1;
+    }
+    const char *p = end + 1;
+    *len = strtoull(p, &end, 0);
+    return (end == p || *end != '\0' || p[0] == '-' || errno != 0) ? -1 : 0;
+}
+
+/* Reads bytes [pos, pos + len) of in into buf. */
+static int read_at(FILE *in, off_t pos, byte_t *buf, size_t len) {
+    return (fseeko(in, pos, SEEK_SET) == 0 && read_full(in, buf, len) == len) ? 0 : -1;
+}
+
+/*
+ * decrypt --range: decrypts only the chunks overlapping plaintext bytes
+ * [off, off + len), STREAM_SEGMENTS at a time on nthreads threads. The last
+ * chunk is always verified as well, since its tag fixes the file length.
+ * Returns the number of bytes written, -1 on error, -2 on auth failure.
+ */
+static long long decrypt_range(FILE *in, FILE *out, const cofb_key_t *key, const byte_t *header,
+                               byte_t *ad, size_t *ad_len, unsigned long long off,
+                               unsigned long long len, unsigned nthreads) {
+    stream_ctx_t c = { key, {0}, ad, 0, 0, 1, 0, nthreads };
+    struct stat sb;
+    size_t segments, pt_len;
+
+    if (read_stream_header(in, header, &c, ad, ad_len) != 0) {
+        return -1;
+    }
+    off_t data = ftello(in);
+    if (data < 0 || fstat(fileno(in), &sb) != 0 || !S_ISREG(sb.st_mode)) {
+        fprintf(stderr, "Error: --range needs a seekable input file\n");
+        return -1;
+    }
+    size_t ct_len = (size_t)(sb.st_size - data);
+    if (sb.st_size < data || cofb_segmented_layout(ct_len, c.seg, &segments, &pt_len) != GFRX_SUCCESS) {
+        fprintf(stderr, "Error: File corrupted (truncated segment)\n");
+        return -1;
+    }
+    if (off > pt_len) {
+        fprintf(stderr, "Error: Range starts beyond the end of the data (%zu bytes)\n", pt_len);
+        return -1;
+    }
+    if (len > pt_len - off) {
+        len = pt_len - off;
+    }
+
+    const size_t stride = c.seg + GFRX_TAG_SIZE;
+    const size_t last = segments - 1;
+    size_t first = (size_t)(off / c.seg);
+    size_t end = len > 0 ? (size_t)((off + len - 1) / c.seg) : first;
+    byte_t *cbuf = malloc(STREAM_SEGMENTS * stride);
+    byte_t *pbuf = malloc(STREAM_SEGMENTS * c.seg);
+    long long ret = 0;
+
+    if (!cbuf || !pbuf) {
+        ret = -1;
+        goto done;
+    }
+    if (end < last || len == 0) {
+        size_t n = ct_len - last * stride;
+        if (read_at(in, data + (off_t)(last * stride), cbuf, n) != 0) {
+            ret = -1;
+            goto done;
+        }
+        c.index = last;
+        size_t out_len;
+        if ((ret = process_chunk(&c, cbuf, n, 1, pbuf, &out_len)) != 0) {
+            goto done;
+        }
+    }
+
+    for (size_t i = first; len > 0 && i <= end; i += STREAM_SEGMENTS) {
+        size_t count = (end - i + 1 < STREAM_SEGMENTS) ? end - i + 1 : STREAM_SEGMENTS;
+        int final = (i + count - 1 == last);
+        size_t n = final ? ct_len - i * stride : count * stride;
+        size_t out_len;
+
+        c.index = i;
+        if (read_at(in, data + (off_t)(i * stride), cbuf, n) != 0) {
+            ret = -1;
+            break;
+        }
+        if ((ret = process_chunk(&c, cbuf, n, final, pbuf, &out_len)) != 0) {
+            break;
+        }
+
+        /* Keep only the requested bytes of this batch. */
+        unsigned long long base = (unsigned long long)i * c.seg;
+        size_t lo = off > base ? (size_t)(off - base) : 0;
+        size_t hi = (off + len < base + out_len) ? (size_t)(off + len - base) : out_len;
+        if (fwrite(pbuf + lo, 1, hi - lo, out) != hi - lo) {
+            ret = -1;
+            break;
+        }
+    }
+    if (ret == 0 && fflush(out) != 0) {
+        ret = -1;
+    }
+
+done:
+    if (pbuf) {
+        secure_zero(pbuf, STREAM_SEGMENTS * c.seg);
+    }
+    free(cbuf);
+    free(pbuf);
+    return ret == 0 ? (long long)len : ret;
+}
+
+/* A whole file mapped for --mmap; empty files are not mapped (data == NULL). */
+typedef struct {
+    byte_t *data;
+    size_t len;
+} mapping_t;
+
+static int map_input(const char *path, mapping_t *m) {
+    struct stat sb;
+    int fd = open(path, O_RDONLY);
+
+    m->data = NULL;
+    m->len = 0;
+    if (fd < 0 || fstat(fd, &sb) != 0) {
+        perror("Error opening file");
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    if (!S_ISREG(sb.st_mode)) {
+        fprintf(stderr, "Error: --mmap needs a regular input file\n");
+        close(fd);
+        return -1;
+    }
+    m->len = (size_t)sb.st_size;
+    if (m->len > 0) {
+        void *p = mmap(NULL, m->len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            perror("Error mapping input");
+            close(fd);
+            return -1;
+        }
+        m->data = p;
+        posix_madvise(p, m->len, POSIX_MADV_SEQUENTIAL);
+    }
+    close(fd);
+    return 0;
+}
+
+/* Creates path with len bytes and maps it writable; blocks are reserved so a full disk fails here, not as SIGBUS. */
+static int map_output(const char *path, size_t len, mapping_t *m) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+
+    m->data = NULL;
+    m->len = len;
+    if (fd < 0) {
+        perror("Error creating output file");
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)len) != 0) {
+        perror("Error sizing output file");
+        close(fd);
+        remove(path);
+        return -1;
+    }
+    if (len > 0) {
+#if defined(__linux__)
+        /* Reserve the blocks up front; elsewhere ftruncate() alone has to do */
+        int err = posix_fallocate(fd, 0, (off_t)len);
+        if (err == ENOSPC || err == EFBIG) {
+            fprintf(stderr, "Error sizing output file: %s\n", strerror(err));
+            close(fd);
+            remove(path);
+            return -1;
+        }
+#endif
+        void *p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            perror("Error mapping output");
+            close(fd);
+            remove(path);
+            return -1;
+        }
+        m->data = p;
+        posix_madvise(p, len, POSIX_MADV_SEQUENTIAL);
+    }
+    close(fd);
+    return 0;
+}
+
+static void unmap_file(mapping_t *m) {
+    if (m->data) {
+        munmap(m->data, m->len);
+        m->data = NULL;
+    }
+}
+
+/* Encrypts input_file into output_file in the streaming format, in place; returns the plaintext size or -1. */
+static long long encrypt_mmap(const char *input_file, const char *output_file, const cofb_key_t *key,
+                              const byte_t *ad, size_t ad_len, unsigned nthreads, stream_stats_t *st) {
+    const size_t seg = COFB_SEGMENT_SIZE_DEFAULT;
+    mapping_t in, out;
+    byte_t nonce[GFRX_NONCE_SIZE];
+    double start = now();
+    double t = start;
+
+    if (ad_len > 0xFFFF) {
+        fprintf(stderr, "Error: AD too long (max 65535 bytes)\n");
+        return -1;
+    }
+    if (map_input(input_file, &in) != 0) {
+        return -1;
+    }
+    size_t hdr = STREAM_HEADER_SIZE + ad_len + GFRX_NONCE_SIZE;
+    if (map_output(output_file, hdr + cofb_segmented_len(in.len, seg), &out) != 0) {
+        unmap_file(&in);
+        return -1;
+    }
+    st->read_time = now() - t;
+
+    cofb_nonce_next(&nonce_gen, nonce);
+    memcpy(out.data, STREAM_MAGIC, 4);
+    out.data[4] = STREAM_VERSION;
+    out.data[5] = 0;
+    store16_le(out.data + 6, (uint16_t)ad_len);
+    store32_le(out.data + 8, (uint32_t)seg);
+    if (ad_len > 0) {
+        memcpy(out.data + STREAM_HEADER_SIZE, ad, ad_len);
+    }
+    memcpy(out.data + STREAM_HEADER_SIZE + ad_len, nonce, GFRX_NONCE_SIZE);
+
+    t = now();
+    int ret = cofb_encrypt_segmented(key, nonce, ad, ad_len, in.data, in.len, seg,
+                                     out.data + hdr, nthreads);
+    st->crypto_time = now() - t;
+
+    t = now();
+    unmap_file(&out);
+    unmap_file(&in);
+    st->write_time = now() - t;
+    st->wall_time = now() - start;
+    st->read_bytes = in.len;
+    st->write_bytes = out.len;
+    if (ret != GFRX_SUCCESS) {
+        remove(output_file);
+        return -1;
+    }
+    return (long long)in.len;
+}
+
+/*
+ * Decrypts a streaming-format file in place. Returns the plaintext size, -1
+ * on error, -2 on authentication failure, or -3 if the file is not in the
+ * streaming format (the caller falls back to the legacy reader).
+ */
+static long long decrypt_mmap(const char *input_file, const char *output_file, const cofb_key_t *key,
+                              byte_t *ad, size_t *ad_len, unsigned nthreads, stream_stats_t *st) {
+    mapping_t in, out;
+    size_t segments, pt_len;
+    double start = now();
+    double t = start;
+
+    if (map_input(input_file, &in) != 0) {
+        return -1;
+    }
+    if (in.len < STREAM_HEADER_SIZE || memcmp(in.data, STREAM_MAGIC, 4) != 0) {
+        unmap_file(&in);
+        return -3;
+    }
+
+    size_t seg = load32_le(in.data + 8);
+    *ad_len = (size_t)in.data[6] | ((size_t)in.data[7] << 8);
+    size_t hdr = STREAM_HEADER_SIZE + *ad_len + GFRX_NONCE_SIZE;
+    if (in.data[4] != STREAM_VERSION || seg == 0 || seg > STREAM_MAX_SEGMENT || in.len < hdr ||
+        cofb_segmented_layout(in.len - hdr, seg, &segments, &pt_len) != GFRX_SUCCESS) {
+        fprintf(stderr, "Error: File corrupted (invalid header)\n");
+        unmap_file(&in);
+        return -1;
+    }
+    memcpy(ad, in.data + STREAM_HEADER_SIZE, *ad_len);
+    if (map_output(output_file, pt_len, &out) != 0) {
+        unmap_file(&in);
+        return -1;
+    }
+    st->read_time = now() - t;
+
+    t = now();
+    int ret = cofb_decrypt_segmented(key, in.data + STREAM_HEADER_SIZE + *ad_len, ad, *ad_len,
+                                     in.data + hdr, in.len - hdr, seg, out.data, nthreads);
+    st->crypto_time = now() - t;
+
+    t = now();
+    unmap_file(&out);
+    unmap_file(&in);
+    st->write_time = now() - t;
+    st->wall_time = now() - start;
+    st->read_bytes = in.len;
+    st->write_bytes = pt_len;
+    if (ret != GFRX_SUCCESS) {
+        remove(output_file);
+        return ret == GFRX_ERR_AUTH ? -2 : -1;
+    }
+    return (long long)pt_len;
+}
+
+static int encrypt_legacy(const char *input_file, const char *output_file, const byte_t *key,
+                          const byte_t *ad, size_t ad_len, size_t *size) {
+    size_t plaintext_len;
+    byte_t *plaintext = read_file(input_file, &plaintext_len);
+    if (!plaintext) return 1;
+
+    byte_t nonce[GFRX_NONCE_SIZE];
+    cofb_nonce_next(&nonce_gen, nonce);
+
+    byte_t *ciphertext = malloc(plaintext_len);
+    byte_t tag[GFRX_TAG_SIZE];
 
+    if (cofb_encrypt(key, nonce, ad, ad_len, plaintext, plaintext_len,
+                    ciphertext, tag) != GFRX_SUCCESS) {
+        fprintf(stderr, "Error: Encryption failed\n");
         free(plaintext);
         free(ciphertext);
+        return 1;
+    }
+
+    FILE *f = open_output(output_file);
+    if (!f) {
+        free(plaintext);
+        free(ciphertext);
+        return 1;
+    }
+
+    uint16_t ad_len_u16 = (uint16_t)ad_len;
+    fwrite(&ad_len_u16, sizeof(uint16_t), 1, f);
+    if (ad_len > 0) {
+        fwrite(ad, 1, ad_len, f);
+    }
+    fwrite(nonce, 1, GFRX_NONCE_SIZE, f);
+    fwrite(tag, 1, GFRX_TAG_SIZE, f);
+    fwrite(ciphertext, 1, plaintext_len, f);
+    close_stream(f);
+
+    *size = plaintext_len;
+    free(plaintext);
+    free(ciphertext);
+    return 0;
+}
 
-    } else if (strcmp(command, "decrypt") == 0) {
-        size_t encrypted_len;
-        byte_t *encrypted = read_file(input_file, &encrypted_len);
-        if (!encrypted) return 1;
+static int decrypt_legacy(const char *input_file, const char *output_file, const byte_t *key,
+                          byte_t *ad, size_t *ad_len, size_t *size) {
+    size_t encrypted_len;
+    byte_t *encrypted = read_file(input_file, &encrypted_len);
+    if (!encrypted) return 1;
 
-        if (encrypted_len < sizeof(uint16_t) + GFRX_NONCE_SIZE + GFRX_TAG_SIZE) {
-            fprintf(stderr, "Error: File too small\n");
+    if (encrypted_len < sizeof(uint16_t) + GFRX_NONCE_SIZE + GFRX_TAG_SIZE) {
+        fprintf(stderr, "Error: File too small\n");
+        free(encrypted);
+        return 1;
+    }
+
+    size_t offset = 0;
+    uint16_t file_ad_len;
+    memcpy(&file_ad_len, encrypted + offset, sizeof(uint16_t));
+    offset += sizeof(uint16_t);
+
+    byte_t *file_ad = NULL;
+    if (file_ad_len > 0) {
+        if (encrypted_len < offset + file_ad_len + GFRX_NONCE_SIZE + GFRX_TAG_SIZE) {
+            fprintf(stderr, "Error: File corrupted (invalid AD length)\n");
             free(encrypted);
             return 1;
         }
+        file_ad = encrypted + offset;
+        offset += file_ad_len;
+    }
+
+    byte_t nonce[GFRX_NONCE_SIZE];
+    byte_t tag[GFRX_TAG_SIZE];
+    memcpy(nonce, encrypted + offset, GFRX_NONCE_SIZE);
+    offset += GFRX_NONCE_SIZE;
+    memcpy(tag, encrypted + offset, GFRX_TAG_SIZE);
+    offset += GFRX_TAG_SIZE;
 
-        size_t offset = 0;
-        uint16_t file_ad_len;
-        memcpy(&file_ad_len, encrypted + offset, sizeof(uint16_t));
-        offset += sizeof(uint16_t);
+    size_t ciphertext_len = encrypted_len - offset;
+    byte_t *ciphertext = encrypted + offset;
+    byte_t *plaintext = malloc(ciphertext_len);
 
-        byte_t *file_ad = NULL;
-        if (file_ad_len > 0) {
-            if (encrypted_len < offset + file_ad_len + GFRX_NONCE_SIZE + GFRX_TAG_SIZE) {
-                fprintf(stderr, "Error: File corrupted (invalid AD length)\n");
-                free(encrypted);
-                return 1;
+    if (cofb_decrypt(key, nonce, file_ad, file_ad_len, ciphertext, ciphertext_len,
+                    tag, plaintext) != GFRX_SUCCESS) {
+        fprintf(stderr, "Error: Decryption failed (wrong key or corrupted file)\n");
+        free(encrypted);
+        free(plaintext);
+        return 1;
+    }
+
+    int ret = 0;
+    if (is_stdio(output_file)) {
+        if (fwrite(plaintext, 1, ciphertext_len, stdout) != ciphertext_len) ret = 1;
+    } else if (write_file(output_file, plaintext, ciphertext_len) != 0) {
+        ret = 1;
+    }
+
+    if (file_ad_len > 0) {
+        memcpy(ad, file_ad, file_ad_len);
+    }
+    *ad_len = file_ad_len;
+    *size = ciphertext_len;
+    free(encrypted);
+    free(plaintext);
+    return ret;
+}
+
+/* encrypt-dir: the files to process, collected up front. */
+typedef struct {
+    char **paths;
+    size_t count;
+    size_t cap;
+} file_list_t;
+
+static int list_add(file_list_t *l, const char *path) {
+    if (l->count == l->cap) {
+        size_t cap = l->cap ? 2 * l->cap : 256;
+        char **paths = realloc(l->paths, cap * sizeof(*paths));
+        if (!paths) {
+            return -1;
+        }
+        l->paths = paths;
+        l->cap = cap;
+    }
+    size_t n = strlen(path) + 1;
+    if ((l->paths[l->count] = malloc(n)) == NULL) {
+        return -1;
+    }
+    memcpy(l->paths[l->count++], path, n);
+    return 0;
+}
+
+static void list_free(file_list_t *l) {
+    for (size_t i = 0; i < l->count; i++) {
+        free(l->paths[i]);
+    }
+    free(l->paths);
+}
+
+static int has_suffix(const char *s, const char *suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+/*
+ * Regular files under dir, recursively, skipping symlinks. With only_enc the
+ * .enc files are listed, otherwise everything except .enc/.dec outputs.
+ */
+static int list_dir(file_list_t *l, const char *dir, int only_enc) {
+    DIR *d = opendir(dir);
+    struct dirent *e;
+    int ret = 0;
+
+    if (!d) {
+        perror(dir);
+        return -1;
+    }
+    while (ret == 0 && (e = readdir(d)) != NULL) {
+        if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) {
+            continue;
+        }
+        size_t n = strlen(dir) + strlen(e->d_name) + 2;
+        char *path = malloc(n);
+        struct stat sb;
+        if (!path) {
+            ret = -1;
+            break;
+        }
+        snprintf(path, n, "%s/%s", dir, e->d_name);
+        if (lstat(path, &sb) == 0) {
+            int is_enc = has_suffix(path, ".enc");
+            if (S_ISDIR(sb.st_mode)) {
+                ret = list_dir(l, path, only_enc);
+            } else if (S_ISREG(sb.st_mode) &&
+                       (only_enc ? is_enc : !is_enc && !has_suffix(path, ".dec"))) {
+                ret = list_add(l, path);
             }
-            file_ad = encrypted + offset;
-            offset += file_ad_len;
         }
+        free(path);
+    }
+    closedir(d);
+    return ret;
+}
 
-        byte_t nonce[GFRX_NONCE_SIZE];
-        byte_t tag[GFRX_TAG_SIZE];
-        memcpy(nonce, encrypted + offset, GFRX_NONCE_SIZE);
-        offset += GFRX_NONCE_SIZE;
-        memcpy(tag, encrypted + offset, GFRX_TAG_SIZE);
-        offset += GFRX_TAG_SIZE;
+/* One path per line; blank lines are ignored. */
+static int list_manifest(file_list_t *l, const char *manifest) {
+    FILE *f = open_input(manifest);
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t n;
+    int ret = 0;
 
-        size_t ciphertext_len = encrypted_len - offset;
-        byte_t *ciphertext = encrypted + offset;
-        byte_t *plaintext = malloc(ciphertext_len);
+    if (!f) {
+        return -1;
+    }
+    while (ret == 0 && (n = getline(&line, &cap, f)) != -1) {
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r')) {
+            line[--n] = '\0';
+        }
+        if (n > 0) {
+            ret = list_add(l, line);
+        }
+    }
+    free(line);
+    close_stream(f);
+    return ret;
+}
 
-        if (cofb_decrypt(key, nonce, file_ad, file_ad_len, ciphertext, ciphertext_len,
-                        tag, plaintext) != GFRX_SUCCESS) {
-            fprintf(stderr, "Error: Decryption failed (wrong key or corrupted file)\n");
-            free(encrypted);
-            free(plaintext);
+typedef struct {
+    const file_list_t *files;
+    const cofb_key_t *key;
+    const byte_t *ad;
+    size_t ad_len;
+    int verify;
+    unsigned file_threads;          /* threads inside one file (verify) */
+    size_t next;                    /* next file index to claim */
+    unsigned long long bytes;
+    size_t failed;
+} batch_t;
+
+/* Encrypts path to path.enc in the streaming format; returns the plaintext size or -1. */
+static long long encrypt_one(const batch_t *b, const char *path) {
+    size_t n = strlen(path) + 5;
+    char *out_path = malloc(n);
+    stream_stats_t st;
+    long long ret = -1;
+
+    if (!out_path) {
+        return -1;
+    }
+    snprintf(out_path, n, "%s.enc", path);
+    memset(&st, 0, sizeof(st));
+
+    FILE *in = fopen(path, "rb");
+    FILE *out = in ? fopen(out_path, "wb") : NULL;
+    if (in && out) {
+        ret = encrypt_stream(in, out, b->key, b->ad, b->ad_len, 0, &st);
+    }
+    if (in) fclose(in);
+    if (out && fclose(out) != 0) {
+        ret = -1;
+    }
+    if (ret < 0) {
+        fprintf(stderr, "Error: %s: %s\n", path, (in && out) ? "encryption failed" : strerror(errno));
+        if (out) remove(out_path);
+    }
+    free(out_path);
+    return ret;
+}
+
+/* Legacy format: streams the ciphertext through cofb_decrypt_update() with no plaintext. */
+static int verify_legacy(FILE *in, const cofb_key_t *key, unsigned long long *bytes) {
+    byte_t buf[64 * 1024];
+    byte_t nonce[GFRX_NONCE_SIZE], tag[GFRX_TAG_SIZE];
+    uint16_t ad_len;
+    cofb_ctx_t ctx;
+    size_t n;
+
+    if (read_full(in, buf, sizeof(uint16_t)) != sizeof(uint16_t)) {
+        return -1;
+    }
+    memcpy(&ad_len, buf, sizeof(uint16_t));
+    if (read_full(in, buf, ad_len) != ad_len ||
+        read_full(in, nonce, GFRX_NONCE_SIZE) != GFRX_NONCE_SIZE ||
+        read_full(in, tag, GFRX_TAG_SIZE) != GFRX_TAG_SIZE) {
+        return -1;
+    }
+    if (cofb_decrypt_init_key(&ctx, key, nonce) != GFRX_SUCCESS ||
+        cofb_decrypt_update_ad(&ctx, buf, ad_len) != GFRX_SUCCESS) {
+        secure_zero(&ctx, sizeof(ctx));
+        return -1;
+    }
+    *bytes = sizeof(uint16_t) + ad_len + GFRX_NONCE_SIZE + GFRX_TAG_SIZE;
+    int ret = 0;
+    while (ret == 0 && (n = read_full(in, buf, sizeof(buf))) > 0) {
+        if (cofb_decrypt_update(&ctx, buf, n, NULL) != GFRX_SUCCESS) {
+            ret = -1;
+        }
+        *bytes += n;
+    }
+    if (ret == 0 && !ferror(in)) {
+        ret = cofb_decrypt_final(&ctx, tag) == GFRX_SUCCESS ? 0 : -2;
+    }
+    secure_zero(&ctx, sizeof(ctx));
+    return ferror(in) ? -1 : ret;
+}
+
+/* Checks every tag of path without producing plaintext; 0 if it verifies, -1 if unreadable, -2 if not. */
+static int verify_one(const batch_t *b, const char *path, unsigned long long *bytes) {
+    FILE *in = open_input(path);
+    byte_t header[STREAM_HEADER_SIZE];
+    int ret;
+
+    *bytes = 0;
+    if (!in) {
+        return -1;
+    }
+    size_t hn = read_full(in, header, sizeof(header));
+    if (hn == sizeof(header) && memcmp(header, STREAM_MAGIC, 4) == 0) {
+        byte_t ad[0x10000];
+        size_t ad_len;
+        stream_ctx_t c = { b->key, {0}, ad, 0, 0, 1, 0, b->file_threads };
+        stream_stats_t st;
+        memset(&st, 0, sizeof(st));
+
+        ret = read_stream_header(in, header, &c, ad, &ad_len);
+        if (ret == 0) {
+            ret = run_serial(in, NULL, &c, &st);
+        }
+        *bytes = sizeof(header) + ad_len + GFRX_NONCE_SIZE + st.read_bytes;
+    } else if (is_stdio(path) || fseek(in, 0, SEEK_SET) != 0) {
+        fprintf(stderr, "Error: Legacy-format files cannot be read from stdin\n");
+        ret = -1;
+    } else {
+        ret = verify_legacy(in, b->key, bytes);
+    }
+    close_stream(in);
+    return ret;
+}
+
+/* Workers claim file indices from a shared counter; each file runs the serial stream path. */
+static void *batch_worker(void *arg) {
+    batch_t *b = arg;
+    for (;;) {
+        size_t i = __atomic_fetch_add(&b->next, 1, __ATOMIC_RELAXED);
+        if (i >= b->files->count) {
+            return NULL;
+        }
+        const char *path = b->files->paths[i];
+        unsigned long long bytes = 0;
+        int ok;
+        if (b->verify) {
+            /* Failed files still count towards the bytes scanned. */
+            int r = verify_one(b, path, &bytes);
+            if (r != 0) {
+                printf("FAIL %s (%s)\n", path, r == -2 ? "authentication failed" : "unreadable or malformed");
+            }
+            ok = (r == 0);
+        } else {
+            long long n = encrypt_one(b, path);
+            ok = (n >= 0);
+            bytes = ok ? (unsigned long long)n : 0;
+        }
+        if (!ok) {
+            __atomic_fetch_add(&b->failed, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_fetch_add(&b->bytes, bytes, __ATOMIC_RELAXED);
+    }
+}
+
+/*
+ * encrypt-dir and verify: the key schedule runs once and the files are
+ * spread over nthreads workers. verify takes a single file, a directory (its
+ * .enc files) or a manifest; a single file gets the threads to itself.
+ */
+static int run_batch(const char *input, int manifest, int verify, const byte_t *key_bytes,
+                     const byte_t *ad, size_t ad_len, unsigned nthreads) {
+    file_list_t files = { NULL, 0, 0 };
+    cofb_key_t key;
+    pthread_t threads[64];
+    unsigned started = 0;
+    struct stat sb;
+    int listed;
+
+    if (manifest) {
+        listed = list_manifest(&files, input);
+    } else if (verify && (is_stdio(input) || (stat(input, &sb) == 0 && !S_ISDIR(sb.st_mode)))) {
+        listed = list_add(&files, input);
+    } else {
+        listed = list_dir(&files, input, verify);
+    }
+    if (listed != 0) {
+        fprintf(stderr, "Error: Cannot list input files\n");
+        list_free(&files);
+        return 1;
+    }
+    if (nthreads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (n > 0) ? (unsigned)n : 1;
+    }
+    if (nthreads > 64) nthreads = 64;
+    unsigned file_threads = (files.count == 1) ? nthreads : 1;
+    if (nthreads > files.count) nthreads = files.count ? (unsigned)files.count : 1;
+
+    cofb_key_init(&key, key_bytes);
+    batch_t b = { &files, &key, ad, ad_len, verify, file_threads, 0, 0, 0 };
+    double start = now();
+    for (unsigned t = 1; t < nthreads; t++) {
+        if (pthread_create(&threads[started], NULL, batch_worker, &b) != 0) {
+            break;
+        }
+        started++;
+    }
+    batch_worker(&b);
+    for (unsigned t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    double elapsed = now() - start;
+    secure_zero(&key, sizeof(key));
+
+    size_t ok = files.count - b.failed;
+    if (verify) {
+        printf("Verified %zu files: %zu passed, %zu failed (%.2f MB in %.3f s, %u threads)\n",
+               files.count, ok, b.failed, b.bytes / (1024.0 * 1024.0), elapsed, started + 1);
+    } else {
+        printf("Encrypted %zu of %zu files (%.2f MB) in %.3f s with %u threads\n",
+               ok, files.count, b.bytes / (1024.0 * 1024.0), elapsed, started + 1);
+    }
+    if (elapsed > 0) {
+        printf("  %.0f files/s, %.2f MB/s\n", ok / elapsed, b.bytes / (1024.0 * 1024.0) / elapsed);
+    }
+    list_free(&files);
+    return b.failed ? 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *positional[4];
+    int npositional = 0;
+    const char *output_arg = NULL;
+    int legacy = 0;
+    int pipelined = 1;
+    int show_stats = 0;
+    int use_mmap = 0;
+    const char *range_arg = NULL;
+    int manifest = 0;
+    unsigned jobs = 0;
+    unsigned long long range_off = 0, range_len = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_arg = argv[++i];
+        } else if (strcmp(argv[i], "--legacy") == 0) {
+            legacy = 1;
+        } else if (strcmp(argv[i], "--serial") == 0) {
+            pipelined = 0;
+        } else if (strcmp(argv[i], "--range") == 0 && i + 1 < argc) {
+            range_arg = argv[++i];
+        } else if (strcmp(argv[i], "--manifest") == 0) {
+            manifest = 1;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jobs = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--mmap") == 0) {
+            use_mmap = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            show_stats = 1;
+        } else if (npositional < 4 && (argv[i][0] != '-' || is_stdio(argv[i]))) {
+            positional[npositional++] = argv[i];
+        } else {
+            print_usage(argv[0]);
             return 1;
         }
+    }
+    if (npositional < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
 
-        char output_file[256];
+    const char *command = positional[0];
+    const char *input_file = positional[1];
+    const char *key_hex = positional[2];
+    const char *ad_string = (npositional == 4) ? positional[3] : NULL;
+
+    byte_t *ad = NULL;
+    size_t ad_len = 0;
+    if (ad_string) {
+        ad = (byte_t *)ad_string;
+        ad_len = strlen(ad_string);
+    }
+
+    byte_t key[GFRX_KEY_SIZE];
+    if (hex_to_bytes(key_hex, key, GFRX_KEY_SIZE) != 0) {
+        fprintf(stderr, "Error: Invalid key format (need 32 hex chars)\n");
+        return 1;
+    }
+
+    if (cofb_nonce_init(&nonce_gen) != GFRX_SUCCESS) {
+        fprintf(stderr, "Error: No entropy source for nonces\n");
+        return 1;
+    }
+
+    if (strcmp(command, "encrypt-dir") == 0 || strcmp(command, "verify") == 0) {
+        int ret = run_batch(input_file, manifest, command[0] == 'v', key, ad, ad_len, jobs);
+        secure_zero(key, sizeof(key));
+        return ret;
+    }
+
+    int is_encrypt = strcmp(command, "encrypt") == 0;
+    if (!is_encrypt && strcmp(command, "decrypt") != 0) {
+        fprintf(stderr, "Error: Unknown command '%s'\n", command);
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    char output_file[256];
+    if (output_arg) {
+        snprintf(output_file, sizeof(output_file), "%s", output_arg);
+    } else if (is_stdio(input_file)) {
+        snprintf(output_file, sizeof(output_file), "-");
+    } else if (is_encrypt) {
+        snprintf(output_file, sizeof(output_file), "%s.enc", input_file);
+    } else {
         const char *enc_ext = strstr(input_file, ".enc");
         if (enc_ext) {
             size_t base_len = enc_ext - input_file;
@@ -209,27 +1411,136 @@ int main(int argc, char *argv[]) {
         } else {
             snprintf(output_file, sizeof(output_file), "%s.dec", input_file);
         }
+    }
 
-        if (write_file(output_file, plaintext, ciphertext_len) != 0) {
-            free(encrypted);
-            free(plaintext);
-            return 1;
+    if (range_arg && (is_encrypt || use_mmap || parse_range(range_arg, &range_off, &range_len) != 0)) {
+        fprintf(stderr, "Error: --range takes <off>:<len> and only applies to decrypt (without --mmap)\n");
+        return 1;
+    }
+    if (use_mmap && (is_stdio(input_file) || is_stdio(output_file) || (is_encrypt && legacy))) {
+        fprintf(stderr, "Error: --mmap needs input and output files and the streaming format\n");
+        return 1;
+    }
+
+    /* Status goes to stderr when stdout carries the data. */
+    FILE *info = is_stdio(output_file) ? stderr : stdout;
+    size_t size = 0;
+    byte_t file_ad[0x10000];
+    size_t file_ad_len = 0;
+    stream_stats_t stats;
+    int streamed = 0;
+    memset(&stats, 0, sizeof(stats));
+
+    cofb_key_t ck;
+    cofb_key_init(&ck, key);
+    int ret = 0;
+
+    if (is_encrypt && legacy) {
+        if (is_stdio(input_file)) {
+            fprintf(stderr, "Error: --legacy needs an input file\n");
+            ret = 1;
+        } else {
+            ret = encrypt_legacy(input_file, output_file, key, ad, ad_len, &size);
         }
 
-        printf("Decrypted: %s -> %s\n", input_file, output_file);
-        if (file_ad_len > 0) {
-            printf("AD: %.*s\n", (int)file_ad_len, file_ad);
+    } else if (is_encrypt && use_mmap) {
+        long long n = encrypt_mmap(input_file, output_file, &ck, ad, ad_len, pipelined ? 0 : 1, &stats);
+        if (n < 0) {
+            fprintf(stderr, "Error: Encryption failed\n");
         }
-        printf("Size: %zu bytes\n", ciphertext_len);
+        streamed = 1;
+        ret = (n < 0);
+        size = (n < 0) ? 0 : (size_t)n;
 
-        free(encrypted);
-        free(plaintext);
+    } else if (use_mmap) {
+        long long n = decrypt_mmap(input_file, output_file, &ck, file_ad, &file_ad_len,
+                                   pipelined ? 0 : 1, &stats);
+        if (n == -3) {
+            ret = decrypt_legacy(input_file, output_file, key, file_ad, &file_ad_len, &size);
+        } else {
+            if (n == -2) {
+                fprintf(stderr, "Error: Decryption failed (wrong key or corrupted file)\n");
+            }
+            streamed = 1;
+            ret = (n < 0);
+            size = (n < 0) ? 0 : (size_t)n;
+        }
+        ad_string = (const char *)file_ad;
+        ad_len = file_ad_len;
+
+    } else if (is_encrypt) {
+        FILE *in = open_input(input_file);
+        FILE *out = in ? open_output(output_file) : NULL;
+        long long n = (in && out) ? encrypt_stream(in, out, &ck, ad, ad_len, pipelined, &stats) : -1;
+        if (n < 0 && in && out) {
+            fprintf(stderr, "Error: Encryption failed\n");
+        }
+        if (in) close_stream(in);
+        if (out) close_stream(out);
+        if (n < 0 && out && !is_stdio(output_file)) {
+            remove(output_file);
+        }
+        streamed = 1;
+        ret = (n < 0);
+        size = (n < 0) ? 0 : (size_t)n;
 
     } else {
-        fprintf(stderr, "Error: Unknown command '%s'\n", command);
-        print_usage(argv[0]);
+        FILE *in = open_input(input_file);
+        byte_t header[STREAM_HEADER_SIZE];
+        size_t hn = in ? read_full(in, header, sizeof(header)) : 0;
+
+        if (!in) {
+            ret = 1;
+        } else if (hn == sizeof(header) && memcmp(header, STREAM_MAGIC, 4) == 0) {
+            FILE *out = open_output(output_file);
+            long long n = -1;
+            if (out && range_arg) {
+                n = decrypt_range(in, out, &ck, header, file_ad, &file_ad_len, range_off, range_len,
+                                  pipelined ? 0 : 1);
+            } else if (out) {
+                n = decrypt_stream(in, out, &ck, header, file_ad, &file_ad_len, pipelined, &stats);
+                streamed = 1;
+            }
+            if (n == -2) {
+                fprintf(stderr, "Error: Decryption failed (wrong key or corrupted file)\n");
+            }
+            if (out) close_stream(out);
+            if (n < 0 && out && !is_stdio(output_file)) {
+                remove(output_file);
+            }
+            close_stream(in);
+            ret = (n < 0);
+            size = (n < 0) ? 0 : (size_t)n;
+        } else if (range_arg) {
+            fprintf(stderr, "Error: --range needs the chunked (streaming) format\n");
+            close_stream(in);
+            ret = 1;
+        } else if (is_stdio(input_file)) {
+            fprintf(stderr, "Error: Legacy-format files cannot be read from stdin\n");
+            ret = 1;
+        } else {
+            close_stream(in);
+            ret = decrypt_legacy(input_file, output_file, key, file_ad, &file_ad_len, &size);
+        }
+        ad_string = (const char *)file_ad;
+        ad_len = file_ad_len;
+    }
+
+    secure_zero(&ck, sizeof(ck));
+    if (ret != 0) {
         return 1;
     }
 
+    fprintf(info, "%s: %s -> %s\n", is_encrypt ? "Encrypted" : "Decrypted",
+            is_stdio(input_file) ? "<stdin>" : input_file,
+            is_stdio(output_file) ? "<stdout>" : output_file);
+    if (ad_len > 0) {
+        fprintf(info, "AD: %.*s\n", (int)ad_len, ad_string);
+    }
+    fprintf(info, "Size: %zu bytes\n", size);
+    if (show_stats && streamed) {
+        print_stats(info, &stats, use_mmap ? "mmap" : pipelined ? "pipelined" : "serial");
+    }
+
     return 0;
 }
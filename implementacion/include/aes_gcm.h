@@ -16,6 +16,16 @@
 
 typedef uint8_t byte_t;
 
+/*
+ * Keyed AES-128-GCM handle: the OpenSSL contexts are allocated and keyed
+ * once by aes_gcm_key_init, then each message only sets a new nonce. Not
+ * safe for concurrent use; give each thread its own handle.
+ */
+typedef struct {
+    struct evp_cipher_ctx_st *enc;
+    struct evp_cipher_ctx_st *dec;
+} aes_gcm_key_t;
+
 /**
  * AES-128-GCM encryption using OpenSSL
  *
@@ -60,4 +70,40 @@ int aes_gcm_decrypt(
     byte_t *plaintext
 );
 
+/**
+ * Allocate and key an AES-128-GCM handle
+ *
+ * @param key        Handle to initialize
+ * @param key_bytes  16-byte key
+ * @return AES_GCM_SUCCESS on success, AES_GCM_ERR_INIT otherwise
+ */
+int aes_gcm_key_init(aes_gcm_key_t *key, const byte_t *key_bytes);
+
+/**
+ * Release the OpenSSL contexts of a handle (safe on a zeroed handle)
+ */
+void aes_gcm_key_free(aes_gcm_key_t *key);
+
+/**
+ * Same as aes_gcm_encrypt/aes_gcm_decrypt with a keyed handle: no allocation
+ * or key expansion per message.
+ */
+int aes_gcm_encrypt_ctx(
+    aes_gcm_key_t *key,
+    const byte_t *nonce,
+    const byte_t *ad, size_t ad_len,
+    const byte_t *plaintext, size_t pt_len,
+    byte_t *ciphertext,
+    byte_t *tag
+);
+
+int aes_gcm_decrypt_ctx(
+    aes_gcm_key_t *key,
+    const byte_t *nonce,
+    const byte_t *ad, size_t ad_len,
+    const byte_t *ciphertext, size_t ct_len,
+    const byte_t *tag,
+    byte_t *plaintext
+);
+
 #endif /* AES_GCM_H */
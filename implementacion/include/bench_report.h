@@ -0,0 +1,40 @@
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+ * Machine-readable benchmark results (--json FILE / --csv FILE), with host
+ * metadata (CPU model, compiler, flags, GFRX backend) so runs from different
+ * machines or commits can be overlaid by generate_graphs.py. Not part of
+ * libgfrx_cofb; linked only into the benchmark programs.
+ */
+
+typedef enum {
+    BENCH_REPORT_NONE = 0,
+    BENCH_REPORT_JSON,
+    BENCH_REPORT_CSV
+} bench_report_format_t;
+
+typedef struct {
+    FILE *fp;
+    bench_report_format_t format;
+    size_t records;
+} bench_report_t;
+
+/*
+ * Parses --json FILE / --csv FILE and opens the report; with neither option
+ * the report stays disabled and bench_report_add() is a no-op. Returns -1
+ * (after printing usage) on an unknown argument or an unwritable file.
+ */
+int bench_report_open_args(bench_report_t *report, const char *benchmark, int argc, char *argv[]);
+
+/* One result row: test name, scheme, message size, thread count and the three metrics. */
+void bench_report_add(bench_report_t *report, const char *test, const char *scheme, size_t bytes,
+                      unsigned threads, double throughput_mbps, double latency_us, size_t iterations);
+
+/* Writes the trailer and closes the file; returns -1 if any write failed. */
+int bench_report_close(bench_report_t *report);
+
+#endif /* BENCH_REPORT_H */
@@ -31,18 +31,182 @@ typedef struct {
     byte_t Y[GFRX_BLOCK_SIZE];
     size_t ad_blocks;
     size_t msg_blocks;
+    byte_t buf[GFRX_BLOCK_SIZE];
+    size_t buf_len;
+    int phase;
 } cofb_ctx_t;
 
+/* Expanded COFB key: run the key schedule once, then reuse for many nonces. */
+typedef struct {
+    gfrx_ctx_t gfrx;
+} cofb_key_t;
+
+/*
+ * One message of a batch. For encryption, in/in_len is the plaintext and
+ * tag receives the tag; for decryption, in is the ciphertext and tag is the
+ * expected tag. out (in_len bytes) may be NULL on decrypt to verify only.
+ */
+typedef struct {
+    const byte_t *nonce;
+    const byte_t *ad;
+    size_t ad_len;
+    const byte_t *in;
+    size_t in_len;
+    byte_t *out;
+    byte_t *tag;
+} cofb_batch_msg_t;
+
+/*
+ * Nonce source: a 64-bit counter whose starting point is read once from
+ * getrandom(). Each call claims the next value(s) with one atomic add, so a
+ * generator never repeats a nonce (for 2^64 calls) and threads share it
+ * without locks. A forked child must call cofb_nonce_init() again.
+ */
+typedef struct {
+    uint64_t next;
+} cofb_nonce_gen_t;
+
 int gfrx_init(gfrx_ctx_t *ctx, const byte_t *key);
 void gfrx_encrypt_block(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
 void gfrx_decrypt_block(const gfrx_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext);
 
+/* Encrypt 2/4/8 independent contiguous blocks with interleaved rounds. */
+void gfrx_encrypt_blocks_x2(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+void gfrx_encrypt_blocks_x4(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+void gfrx_encrypt_blocks_x8(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+/* Multi-key variants: block i is encrypted under ctx[i]. */
+void gfrx_encrypt_blocks_mk_x2(const gfrx_ctx_t *const ctx[2], const byte_t *plaintext, byte_t *ciphertext);
+void gfrx_encrypt_blocks_mk_x4(const gfrx_ctx_t *const ctx[4], const byte_t *plaintext, byte_t *ciphertext);
+void gfrx_encrypt_blocks_mk_x8(const gfrx_ctx_t *const ctx[8], const byte_t *plaintext, byte_t *ciphertext);
+
+/* SSE2 word-sliced 4-way kernels; only call when gfrx_sse2_available() is non-zero. */
+int gfrx_sse2_available(void);
+void gfrx_encrypt_blocks_sse2_x4(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+void gfrx_encrypt_blocks_sse2_mk_x4(const gfrx_ctx_t *const ctx[4], const byte_t *plaintext, byte_t *ciphertext);
+
+/* AVX2 word-sliced 8-way kernels; only call when gfrx_avx2_available() is non-zero. */
+int gfrx_avx2_available(void);
+void gfrx_encrypt_blocks_avx2_x8(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+void gfrx_encrypt_blocks_avx2_mk_x8(const gfrx_ctx_t *const ctx[8], const byte_t *plaintext, byte_t *ciphertext);
+
+/* AVX-512F word-sliced 16-way kernels; only call when gfrx_avx512_available() is non-zero. */
+int gfrx_avx512_available(void);
+void gfrx_encrypt_blocks_avx512_x16(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+void gfrx_encrypt_blocks_avx512_mk_x16(const gfrx_ctx_t *const ctx[16], const byte_t *plaintext, byte_t *ciphertext);
+
+/*
+ * Runtime-dispatched multi-block encryption for any nblocks. The backend
+ * (scalar, sse2, avx2, avx512) is picked from CPUID on first use, or forced
+ * with the GFRX_BACKEND environment variable or gfrx_set_backend()
+ * (NULL restores automatic selection).
+ */
+void gfrx_encrypt_blocks(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext, size_t nblocks);
+void gfrx_encrypt_blocks_mk(const gfrx_ctx_t *const *ctx, const byte_t *plaintext, byte_t *ciphertext, size_t nblocks);
+const char *gfrx_backend_name(void);
+size_t gfrx_backend_lanes(void);
+int gfrx_set_backend(const char *name);
+
 int cofb_init(cofb_ctx_t *ctx, const byte_t *key, const byte_t *nonce);
 int cofb_encrypt(const byte_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
                  const byte_t *plaintext, size_t plaintext_len, byte_t *ciphertext, byte_t *tag);
 int cofb_decrypt(const byte_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
                  const byte_t *ciphertext, size_t ciphertext_len, const byte_t *tag, byte_t *plaintext);
 
+int cofb_key_init(cofb_key_t *key, const byte_t *key_bytes);
+int cofb_encrypt_ctx(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                     const byte_t *plaintext, size_t plaintext_len, byte_t *ciphertext, byte_t *tag);
+int cofb_decrypt_ctx(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                     const byte_t *ciphertext, size_t ciphertext_len, const byte_t *tag, byte_t *plaintext);
+
+/*
+ * Batch API: runs the chains of many messages under one key in lockstep on
+ * the multi-block kernel. Output is identical to cofb_encrypt_ctx() and
+ * cofb_decrypt_ctx() per message. On decrypt, bit i of auth_bitmap
+ * ((count + 7) / 8 bytes, may be NULL) is set when message i verifies; the
+ * plaintext of every failing message is zeroed and GFRX_ERR_AUTH returned.
+ */
+int cofb_encrypt_batch(const cofb_key_t *key, const cofb_batch_msg_t *msgs, size_t count);
+int cofb_decrypt_batch(const cofb_key_t *key, const cofb_batch_msg_t *msgs, size_t count, uint8_t *auth_bitmap);
+
+/*
+ * Segmented COFB for large objects: the message is split into segment_size
+ * chunks, each encrypted under a nonce derived from (nonce, index, last)
+ * and carrying its own tag, so segments run in parallel on nthreads threads
+ * (0 = one per online CPU). Output is C_0 || T_0 || ... || C_last || T_last,
+ * cofb_segmented_len() bytes in total; ad is bound to every segment.
+ *
+ * Limit: segment nonces are a 64-bit truncated PRF output, so like random
+ * nonces they collide by the birthday bound. Keep the total number of
+ * segments under one key, over all objects, below COFB_SEGMENTS_PER_KEY
+ * (collision chance about 2^-17 there), then rotate the key. Plain
+ * cofb_encrypt_ctx() messages under the same key add to that count.
+ */
+#define COFB_SEGMENT_SIZE_DEFAULT   (64 * 1024)
+#define COFB_SEGMENTS_PER_KEY       (1ull << 24)
+#define COFB_SEGMENT_MAX_THREADS    64
+
+size_t cofb_segment_count(size_t plaintext_len, size_t segment_size);
+size_t cofb_segmented_len(size_t plaintext_len, size_t segment_size);
+int cofb_segment_nonce(const cofb_key_t *key, const byte_t *nonce, uint64_t index, int last,
+                       byte_t *segment_nonce);
+/* ciphertext_len -> number of segments and plaintext length; GFRX_ERR_INVALID if malformed. */
+int cofb_segmented_layout(size_t ciphertext_len, size_t segment_size,
+                          size_t *segments, size_t *plaintext_len);
+/* One segment: out / in is the segment ciphertext followed by its tag. */
+int cofb_encrypt_segment(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                         uint64_t index, int last, const byte_t *plaintext, size_t plaintext_len,
+                         byte_t *out);
+int cofb_decrypt_segment(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                         uint64_t index, int last, const byte_t *in, size_t in_len,
+                         byte_t *plaintext);
+int cofb_encrypt_segmented(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                           const byte_t *plaintext, size_t plaintext_len,
+                           size_t segment_size, byte_t *ciphertext, unsigned nthreads);
+int cofb_decrypt_segmented(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                           const byte_t *ciphertext, size_t ciphertext_len,
+                           size_t segment_size, byte_t *plaintext, unsigned nthreads);
+/*
+ * Segments first, first + 1, ... of a segmented message, e.g. one buffer of a
+ * stream or the chunks behind a byte range. final marks the range holding the
+ * last segment; a range that is not final must cover whole segments.
+ * Decrypt takes plaintext == NULL to check the tags only.
+ */
+int cofb_encrypt_segments(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                          uint64_t first, int final, const byte_t *plaintext, size_t plaintext_len,
+                          size_t segment_size, byte_t *out, unsigned nthreads);
+int cofb_decrypt_segments(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                          uint64_t first, int final, const byte_t *in, size_t in_len,
+                          size_t segment_size, byte_t *plaintext, unsigned nthreads);
+
+/*
+ * Streaming API: AD and message may be fed in chunks of any size; partial
+ * blocks are buffered in the context. update() writes exactly in_len output
+ * bytes. Decrypt releases plaintext before the tag is checked, so callers
+ * must discard it if cofb_decrypt_final() returns GFRX_ERR_AUTH; plaintext
+ * may be NULL to verify only. The _init_key variants take a key expanded by
+ * cofb_key_init() instead of running the key schedule per message.
+ */
+int cofb_init_key(cofb_ctx_t *ctx, const cofb_key_t *key, const byte_t *nonce);
+int cofb_encrypt_init(cofb_ctx_t *ctx, const byte_t *key, const byte_t *nonce);
+int cofb_encrypt_init_key(cofb_ctx_t *ctx, const cofb_key_t *key, const byte_t *nonce);
+int cofb_encrypt_update_ad(cofb_ctx_t *ctx, const byte_t *ad, size_t ad_len);
+int cofb_encrypt_update(cofb_ctx_t *ctx, const byte_t *plaintext, size_t plaintext_len, byte_t *ciphertext);
+int cofb_encrypt_final(cofb_ctx_t *ctx, byte_t *tag);
+
+int cofb_decrypt_init(cofb_ctx_t *ctx, const byte_t *key, const byte_t *nonce);
+int cofb_decrypt_init_key(cofb_ctx_t *ctx, const cofb_key_t *key, const byte_t *nonce);
+int cofb_decrypt_update_ad(cofb_ctx_t *ctx, const byte_t *ad, size_t ad_len);
+int cofb_decrypt_update(cofb_ctx_t *ctx, const byte_t *ciphertext, size_t ciphertext_len, byte_t *plaintext);
+int cofb_decrypt_final(cofb_ctx_t *ctx, const byte_t *tag);
+
+/* GFRX_ERR_INVALID if no entropy is available; there is no weak fallback. */
+int cofb_nonce_init(cofb_nonce_gen_t *gen);
+/* Deterministic start, e.g. a counter persisted with the key. */
+void cofb_nonce_init_counter(cofb_nonce_gen_t *gen, uint64_t start);
+void cofb_nonce_next(cofb_nonce_gen_t *gen, byte_t *nonce);
+/* count consecutive nonces, GFRX_NONCE_SIZE bytes each, for one atomic add. */
+void cofb_nonce_next_n(cofb_nonce_gen_t *gen, byte_t *nonces, size_t count);
+
 int secure_compare(const byte_t *a, const byte_t *b, size_t len);
 void secure_zero(void *ptr, size_t len);
 
@@ -0,0 +1,61 @@
+#ifndef GFRX_ENGINE_H
+#define GFRX_ENGINE_H
+
+#include "gfrx_cofb.h"
+
+/*
+ * Bulk AEAD engine: N worker threads, each with its own task deque. Workers
+ * pop their own newest task and steal the oldest task of another worker
+ * when idle. A segmented job (segment_size > 0) is split into halves on
+ * demand, so idle workers can take over parts of one large message while
+ * small jobs keep flowing.
+ */
+
+#define GFRX_JOB_ENCRYPT    0
+#define GFRX_JOB_DECRYPT    1
+
+typedef struct gfrx_engine gfrx_engine_t;
+
+typedef struct gfrx_job {
+    int op;                     /* GFRX_JOB_ENCRYPT or GFRX_JOB_DECRYPT */
+    const cofb_key_t *key;
+    const byte_t *nonce;
+    const byte_t *ad;
+    size_t ad_len;
+    const byte_t *in;
+    size_t in_len;
+    byte_t *out;
+    byte_t *tag;                /* output on encrypt, expected tag on decrypt; unused when segmented */
+    size_t segment_size;        /* 0: one COFB message; otherwise the cofb_encrypt_segmented() layout */
+
+    /* Called on a worker thread when the job completes; if NULL the job goes to the completion queue. */
+    void (*done)(struct gfrx_job *job);
+    void *user;
+
+    int result;                 /* GFRX_SUCCESS, GFRX_ERR_AUTH or GFRX_ERR_INVALID once completed */
+
+    /* Engine-private */
+    size_t segments;
+    size_t plaintext_len;
+    size_t pending;
+    int failed;
+    struct gfrx_job *next;
+} gfrx_job_t;
+
+/* nthreads = 0 starts one worker per online CPU. Returns NULL on failure. */
+gfrx_engine_t *gfrx_engine_create(unsigned nthreads);
+unsigned gfrx_engine_threads(const gfrx_engine_t *engine);
+
+/* The job and every buffer it points to must stay valid until it completes. */
+int gfrx_engine_submit(gfrx_engine_t *engine, gfrx_job_t *job);
+
+/* Next completed job without a callback; blocks. NULL once no job is outstanding. */
+gfrx_job_t *gfrx_engine_wait(gfrx_engine_t *engine);
+
+/* Blocks until every submitted job has completed (callbacks included). */
+void gfrx_engine_drain(gfrx_engine_t *engine);
+
+/* Drains, stops the workers and frees the engine. */
+void gfrx_engine_destroy(gfrx_engine_t *engine);
+
+#endif // GFRX_ENGINE_H
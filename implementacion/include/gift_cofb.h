@@ -23,18 +23,10 @@ typedef uint32_t word32_t;
 /* GIFT-128 context */
 typedef struct {
     word32_t round_keys[2 * GIFT_ROUNDS];  // Round keys
+    word32_t fs_keys[4 * GIFT_ROUNDS];     // Round keys + constants, fixsliced
     word32_t state[4];                     // 128-bit state (4x32 bits)
 } gift_ctx_t;
 
-/* GIFT-COFB context */
-typedef struct {
-    gift_ctx_t gift;
-    uint64_t delta;
-    byte_t Y[GIFT_BLOCK_SIZE];
-    size_t ad_blocks;
-    size_t msg_blocks;
-} gift_cofb_ctx_t;
-
 /**
  * Initialize GIFT-128 context with key
  */
@@ -50,6 +42,48 @@ void gift_encrypt_block(const gift_ctx_t *ctx, const byte_t *plaintext, byte_t *
  */
 void gift_decrypt_block(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext);
 
+/**
+ * Block cipher implementations behind gift_encrypt_block/gift_decrypt_block:
+ * the bit-by-bit reference and the fixsliced one (same outputs). Both take a
+ * context from gift_init.
+ */
+void gift_encrypt_block_reference(const gift_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+void gift_decrypt_block_reference(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext);
+void gift_encrypt_block_fixsliced(const gift_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+void gift_decrypt_block_fixsliced(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext);
+
+/**
+ * Encrypt a block held as four little-endian words, in place (the form
+ * GIFT-COFB works on); gift_encrypt_words dispatches like gift_encrypt_block
+ */
+void gift_encrypt_words(const gift_ctx_t *ctx, word32_t *state);
+void gift_encrypt_words_reference(const gift_ctx_t *ctx, word32_t *state);
+void gift_encrypt_words_fixsliced(const gift_ctx_t *ctx, word32_t *state);
+
+/**
+ * Derive fs_keys from round_keys (called by gift_init)
+ */
+void gift_fixsliced_key_schedule(gift_ctx_t *ctx);
+
+/**
+ * Select the block cipher implementation: "fixsliced" (default) or
+ * "reference"; NULL restores the default. GIFT_BACKEND in the environment
+ * sets the initial choice. Returns GIFT_ERR_INVALID for an unknown name.
+ */
+int gift_set_backend(const char *name);
+
+/**
+ * Name of the implementation in use
+ */
+const char *gift_backend_name(void);
+
+/**
+ * Word-level encrypt of the implementation in use, so a caller can pick
+ * its code path once instead of dispatching per block
+ */
+typedef void (*gift_words_fn)(const gift_ctx_t *ctx, word32_t *state);
+gift_words_fn gift_backend_encrypt_words(void);
+
 /**
  * GIFT-COFB encryption
  */
@@ -74,4 +108,25 @@ int gift_cofb_decrypt(
     byte_t *plaintext
 );
 
+/**
+ * GIFT-COFB with a key already expanded by gift_init, to reuse across nonces
+ */
+int gift_cofb_encrypt_ctx(
+    const gift_ctx_t *ctx,
+    const byte_t *nonce,
+    const byte_t *ad, size_t ad_len,
+    const byte_t *plaintext, size_t plaintext_len,
+    byte_t *ciphertext,
+    byte_t *tag
+);
+
+int gift_cofb_decrypt_ctx(
+    const gift_ctx_t *ctx,
+    const byte_t *nonce,
+    const byte_t *ad, size_t ad_len,
+    const byte_t *ciphertext, size_t ciphertext_len,
+    const byte_t *tag,
+    byte_t *plaintext
+);
+
 #endif /* GIFT_COFB_H */
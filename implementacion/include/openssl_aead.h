@@ -0,0 +1,64 @@
+#ifndef OPENSSL_AEAD_H
+#define OPENSSL_AEAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Further OpenSSL AEADs for comparison_benchmark, with the same shape as
+ * aes_gcm.h: one-shot calls plus a keyed handle re-nonced per message.
+ * Both algorithms take a 128-bit tag; see ossl_aead_key_size() and
+ * ossl_aead_nonce_size() for the rest.
+ */
+
+#define OSSL_AEAD_TAG_SIZE      16
+#define OSSL_AEAD_MAX_NONCE     12
+
+#define OSSL_AEAD_SUCCESS       0
+#define OSSL_AEAD_ERR_AUTH     -1
+#define OSSL_AEAD_ERR_INIT     -2
+
+typedef uint8_t byte_t;
+
+typedef enum {
+    OSSL_AEAD_CHACHA20_POLY1305,    /* RFC 8439: 256-bit key, 96-bit nonce */
+    OSSL_AEAD_AES_128_OCB           /* RFC 7253: 128-bit key, 96-bit nonce */
+} ossl_aead_alg_t;
+
+/* Keyed handle; not safe for concurrent use. */
+typedef struct {
+    struct evp_cipher_ctx_st *enc;
+    struct evp_cipher_ctx_st *dec;
+} ossl_aead_key_t;
+
+size_t ossl_aead_key_size(ossl_aead_alg_t alg);
+size_t ossl_aead_nonce_size(ossl_aead_alg_t alg);
+
+/**
+ * One-shot encryption/decryption: a fresh OpenSSL context per call
+ */
+int ossl_aead_encrypt(ossl_aead_alg_t alg, const byte_t *key, const byte_t *nonce,
+                      const byte_t *ad, size_t ad_len,
+                      const byte_t *plaintext, size_t pt_len,
+                      byte_t *ciphertext, byte_t *tag);
+int ossl_aead_decrypt(ossl_aead_alg_t alg, const byte_t *key, const byte_t *nonce,
+                      const byte_t *ad, size_t ad_len,
+                      const byte_t *ciphertext, size_t ct_len,
+                      const byte_t *tag, byte_t *plaintext);
+
+/**
+ * Keyed handle: contexts allocated and keyed once, only the nonce changes
+ * per message. ossl_aead_key_free is safe on a zeroed handle.
+ */
+int ossl_aead_key_init(ossl_aead_key_t *key, ossl_aead_alg_t alg, const byte_t *key_bytes);
+void ossl_aead_key_free(ossl_aead_key_t *key);
+int ossl_aead_encrypt_ctx(ossl_aead_key_t *key, const byte_t *nonce,
+                          const byte_t *ad, size_t ad_len,
+                          const byte_t *plaintext, size_t pt_len,
+                          byte_t *ciphertext, byte_t *tag);
+int ossl_aead_decrypt_ctx(ossl_aead_key_t *key, const byte_t *nonce,
+                          const byte_t *ad, size_t ad_len,
+                          const byte_t *ciphertext, size_t ct_len,
+                          const byte_t *tag, byte_t *plaintext);
+
+#endif /* OPENSSL_AEAD_H */
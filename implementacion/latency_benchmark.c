@@ -0,0 +1,341 @@
+#ifdef __linux__
+#define _GNU_SOURCE             /* sched_setaffinity, sched_getcpu */
+#include <sched.h>
+#endif
+
+#include "include/gfrx_cofb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+/*
+ * Per-call latency benchmark. Every call is timed on its own (fenced rdtsc,
+ * or CLOCK_MONOTONIC_RAW without a TSC) on a pinned core after a warm-up,
+ * and the report gives percentiles instead of a mean, so interrupts and
+ * page faults land in p99.9 instead of skewing the typical cost.
+ */
+
+#define DEFAULT_SAMPLES     10000
+#define MIN_SAMPLES         1000
+#define CASE_BUDGET         0.25        /* seconds of samples per case */
+#define MAX_SIZE            (1 << 20)
+
+enum { OP_BLOCK, OP_ENCRYPT, OP_ENCRYPT_CTX, OP_DECRYPT, OP_DECRYPT_BADTAG, OP_COUNT };
+
+static const char *const OP_NAMES[OP_COUNT] = {
+    "gfrx_encrypt_block", "cofb_encrypt", "cofb_encrypt_ctx", "cofb_decrypt", "cofb_decrypt(bad tag)",
+};
+
+static const size_t DEFAULT_SIZES[] = {
+    0, 1, 8, 15, 16, 17, 24, 31, 32, 33, 48, 63, 64, 65, 96, 127, 128, 129, 192, 256,
+    384, 512, 768, 1024, 1536, 2048, 4096, 8192, 16384, 65536,
+};
+
+typedef struct {
+    byte_t key[GFRX_KEY_SIZE];
+    byte_t nonce[GFRX_NONCE_SIZE];
+    gfrx_ctx_t gfrx;
+    cofb_key_t cofb;
+    byte_t *pt;
+    byte_t *ct;
+    byte_t *out;
+    byte_t tag[GFRX_TAG_SIZE];
+    byte_t bad_tag[GFRX_TAG_SIZE];
+} bench_t;
+
+static inline uint64_t ticks(void) {
+#if HAVE_TSC
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static double raw_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Ticks per nanosecond, measured against CLOCK_MONOTONIC_RAW over 50 ms. */
+static double calibrate_ticks(void) {
+    double t0 = raw_seconds();
+    uint64_t c0 = ticks();
+    while (raw_seconds() - t0 < 0.05) {
+    }
+    double t1 = raw_seconds();
+    uint64_t c1 = ticks();
+    return (double)(c1 - c0) / ((t1 - t0) * 1e9);
+}
+
+/*
+ * Core cycles per TSC tick: a chain of dependent imuls costs 3 core cycles
+ * each on current x86 cores, whatever the TSC rate. Far from 1.0 means
+ * turbo or power saving is active; a change between start and end means
+ * the clock moved during the run.
+ */
+static double core_clock_ratio(void) {
+#if HAVE_TSC
+    const int n = 5000000;
+    unsigned long x = 3;
+    uint64_t t0 = ticks();
+    for (int i = 0; i < n; i++) {
+        __asm__ volatile("imul %0, %0\n\timul %0, %0\n\timul %0, %0\n\timul %0, %0" : "+r"(x));
+    }
+    uint64_t t1 = ticks();
+    return 12.0 * n / (double)(t1 - t0);
+#else
+    return 1.0;
+#endif
+}
+
+/* Smallest cost of an empty timed region, subtracted from every sample. */
+static uint64_t timer_overhead(void) {
+    uint64_t best = ~0ull;
+    for (int i = 0; i < 10000; i++) {
+        uint64_t t0 = ticks();
+        uint64_t t1 = ticks();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return best;
+}
+
+static int read_line(const char *path, char *buf, size_t len) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+    int ok = fgets(buf, (int)len, f) != NULL;
+    fclose(f);
+    if (!ok) {
+        return -1;
+    }
+    buf[strcspn(buf, "\n")] = '\0';
+    return 0;
+}
+
+/* Linux only; elsewhere the run is not pinned and -c is ignored. */
+#ifdef __linux__
+#define CAN_PIN 1
+static int pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+#else
+#define CAN_PIN 0
+static int pin_to_cpu(int cpu) {
+    (void)cpu;
+    return -1;
+}
+#endif
+
+static inline void run_op(bench_t *b, int op, size_t size) {
+    switch (op) {
+    case OP_BLOCK:
+        gfrx_encrypt_block(&b->gfrx, b->pt, b->out);
+        break;
+    case OP_ENCRYPT:
+        cofb_encrypt(b->key, b->nonce, NULL, 0, b->pt, size, b->out, b->tag);
+        break;
+    case OP_ENCRYPT_CTX:
+        cofb_encrypt_ctx(&b->cofb, b->nonce, NULL, 0, b->pt, size, b->out, b->tag);
+        break;
+    case OP_DECRYPT:
+        cofb_decrypt(b->key, b->nonce, NULL, 0, b->ct, size, b->tag, b->out);
+        break;
+    default:
+        cofb_decrypt(b->key, b->nonce, NULL, 0, b->ct, size, b->bad_tag, b->out);
+        break;
+    }
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t *sorted, size_t n, double p) {
+    size_t i = (size_t)(p * (n - 1) + 0.5);
+    return sorted[i < n ? i : n - 1];
+}
+
+/* Warms up for warmup_s, then times each call separately; samples come back sorted. */
+static size_t measure(bench_t *b, int op, size_t size, uint64_t *samples, size_t max_samples,
+                      double warmup_s, double ticks_per_ns, uint64_t overhead) {
+    double end = raw_seconds() + warmup_s;
+    uint64_t t0 = ticks();
+    size_t calls = 0;
+    do {
+        run_op(b, op, size);
+        calls++;
+    } while (calls < 16 || raw_seconds() < end);
+
+    /* Fit the sample count to the time budget, but keep enough for p99.9. */
+    double per_call_ns = (double)(ticks() - t0) / ticks_per_ns / (double)calls;
+    size_t n = (size_t)(CASE_BUDGET * 1e9 / (per_call_ns > 1 ? per_call_ns : 1));
+    if (n > max_samples) n = max_samples;
+    if (n < MIN_SAMPLES) n = MIN_SAMPLES;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t s = ticks();
+        run_op(b, op, size);
+        uint64_t e = ticks();
+        uint64_t d = e - s;
+        samples[i] = d > overhead ? d - overhead : 0;
+    }
+    qsort(samples, n, sizeof(*samples), compare_u64);
+    return n;
+}
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [-c cpu] [-n samples] [-w warmup_ms] [--sweep lo:hi:step]\n", prog);
+    printf("  -c      core to pin to (default: the current one)\n");
+    printf("  -n      maximum samples per case (default %d)\n", DEFAULT_SAMPLES);
+    printf("  -w      warm-up per case in ms (default 20; the first case also warms up 500 ms)\n");
+    printf("  --sweep message sizes lo, lo+step, ..., hi instead of the default list\n");
+}
+
+int main(int argc, char *argv[]) {
+#ifdef __linux__
+    int cpu = sched_getcpu();
+#else
+    int cpu = 0;
+#endif
+    size_t max_samples = DEFAULT_SAMPLES;
+    double warmup_s = 0.02;
+    size_t sweep_lo = 0, sweep_hi = 0, sweep_step = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            cpu = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            max_samples = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            warmup_s = atof(argv[++i]) / 1000.0;
+        } else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc &&
+                   sscanf(argv[++i], "%zu:%zu:%zu", &sweep_lo, &sweep_hi, &sweep_step) == 3 &&
+                   sweep_step > 0 && sweep_lo <= sweep_hi && sweep_hi <= MAX_SIZE) {
+            continue;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (max_samples < MIN_SAMPLES) max_samples = MIN_SAMPLES;
+    if (cpu < 0) cpu = 0;
+
+    size_t nsizes = sweep_step ? (sweep_hi - sweep_lo) / sweep_step + 1
+                               : sizeof(DEFAULT_SIZES) / sizeof(DEFAULT_SIZES[0]);
+    size_t max_size = sweep_step ? sweep_hi : DEFAULT_SIZES[nsizes - 1];
+
+    bench_t b;
+    uint64_t *samples = malloc(max_samples * sizeof(*samples));
+    b.pt = malloc(max_size + GFRX_BLOCK_SIZE);
+    b.ct = malloc(max_size + GFRX_BLOCK_SIZE);
+    b.out = malloc(max_size + GFRX_BLOCK_SIZE);
+    if (!samples || !b.pt || !b.ct || !b.out) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) b.key[i] = i;
+    for (int i = 0; i < GFRX_NONCE_SIZE; i++) b.nonce[i] = 0xA0 + i;
+    for (size_t i = 0; i < max_size + GFRX_BLOCK_SIZE; i++) b.pt[i] = i & 0xFF;
+    gfrx_init(&b.gfrx, b.key);
+    cofb_key_init(&b.cofb, b.key);
+
+    printf("GFRX+COFB Latency Benchmark\n\n");
+    if (!CAN_PIN) {
+        printf("Note: CPU pinning is only supported on Linux; results may include migrations\n");
+    } else if (pin_to_cpu(cpu) != 0) {
+        printf("Warning: cannot pin to CPU %d; results may include migrations\n", cpu);
+    } else {
+        printf("Pinned to CPU %d\n", cpu);
+    }
+
+    char governor[64];
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor", cpu);
+    if (read_line(path, governor, sizeof(governor)) == 0) {
+        printf("Governor: %s%s\n", governor,
+               strcmp(governor, "performance") == 0 ? "" : " (not 'performance': frequency may scale)");
+    } else {
+        printf("Governor: unknown (no cpufreq)\n");
+    }
+
+    /* Global warm-up so the first case does not pay for the clock ramping up. */
+    double end = raw_seconds() + 0.5;
+    while (raw_seconds() < end) {
+        run_op(&b, OP_ENCRYPT, max_size < 1024 ? max_size : 1024);
+    }
+
+    double ticks_per_ns = calibrate_ticks();
+    double ratio_start = core_clock_ratio();
+    uint64_t overhead = timer_overhead();
+    if (HAVE_TSC) {
+        printf("TSC: %.3f GHz (against CLOCK_MONOTONIC_RAW), timer overhead %llu cycles (subtracted)\n",
+               ticks_per_ns, (unsigned long long)overhead);
+    } else {
+        printf("No TSC: times in ns from CLOCK_MONOTONIC_RAW, overhead %llu ns (subtracted)\n",
+               (unsigned long long)overhead);
+    }
+
+    printf("\nPer-call %s (after subtracting the timer overhead):\n", HAVE_TSC ? "cycles" : "nanoseconds");
+    printf("%-22s %6s %9s %9s %9s %9s %10s %10s\n", "Operation", "Bytes", "min", "p50", "p99",
+           "p99.9", "p50/byte", "p50 ns");
+    for (int op = 0; op < OP_COUNT; op++) {
+        for (size_t s = 0; s < (op == OP_BLOCK ? 1 : nsizes); s++) {
+            size_t size = op == OP_BLOCK ? GFRX_BLOCK_SIZE
+                        : sweep_step ? sweep_lo + s * sweep_step : DEFAULT_SIZES[s];
+
+            if (op >= OP_DECRYPT) {
+                cofb_encrypt(b.key, b.nonce, NULL, 0, b.pt, size, b.ct, b.tag);
+                memcpy(b.bad_tag, b.tag, GFRX_TAG_SIZE);
+                b.bad_tag[GFRX_TAG_SIZE - 1] ^= 1;
+            }
+            size_t n = measure(&b, op, size, samples, max_samples, warmup_s, ticks_per_ns, overhead);
+            uint64_t p50 = percentile(samples, n, 0.50);
+
+            printf("%-22s %6zu %9llu %9llu %9llu %9llu", OP_NAMES[op], size,
+                   (unsigned long long)samples[0], (unsigned long long)p50,
+                   (unsigned long long)percentile(samples, n, 0.99),
+                   (unsigned long long)percentile(samples, n, 0.999));
+            if (size > 0) {
+                printf(" %10.2f", (double)p50 / size);
+            } else {
+                printf(" %10s", "-");
+            }
+            printf(" %10.1f\n", HAVE_TSC ? p50 / ticks_per_ns : (double)p50);
+        }
+    }
+
+    double ratio_end = core_clock_ratio();
+    printf("\nCore/TSC clock ratio: %.3f at start, %.3f at end\n", ratio_start, ratio_end);
+    if (ratio_start / ratio_end > 1.03 || ratio_end / ratio_start > 1.03) {
+        printf("Warning: the core clock changed during the run; repeat with a fixed frequency\n");
+    } else if (ratio_start > 1.05 || ratio_start < 0.95) {
+        printf("Note: the core runs at %.2fx the TSC rate (turbo or power saving); cycles above are TSC ticks\n",
+               ratio_start);
+    }
+
+    free(samples);
+    free(b.pt);
+    free(b.ct);
+    free(b.out);
+    return 0;
+}
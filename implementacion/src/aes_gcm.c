@@ -20,6 +20,10 @@ int aes_gcm_encrypt(
     int len;
     int ciphertext_len;
 
+    if (!key || !nonce) {
+        return AES_GCM_ERR_INIT;
+    }
+
     /* Create and initialize the context */
     if (!(ctx = EVP_CIPHER_CTX_new())) {
         return AES_GCM_ERR_INIT;
@@ -58,14 +62,16 @@ int aes_gcm_encrypt(
             return AES_GCM_ERR_INIT;
         }
         ciphertext_len = len;
+    } else {
+        ciphertext_len = 0;
+    }
 
-        /* Finalize encryption */
-        if (EVP_EncryptFinal_ex(ctx, ciphertext + len, &len) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            return AES_GCM_ERR_INIT;
-        }
-        ciphertext_len += len;
+    /* Finalize encryption (computes the tag, also for an empty message) */
+    if (EVP_EncryptFinal_ex(ctx, ciphertext + ciphertext_len, &len) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        return AES_GCM_ERR_INIT;
     }
+    ciphertext_len += len;
 
     /* Get the tag */
     if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, AES_TAG_SIZE, tag) != 1) {
@@ -93,6 +99,10 @@ int aes_gcm_decrypt(
     int plaintext_len;
     int ret;
 
+    if (!key || !nonce || !tag) {
+        return AES_GCM_ERR_INIT;
+    }
+
     /* Create and initialize the context */
     if (!(ctx = EVP_CIPHER_CTX_new())) {
         return AES_GCM_ERR_INIT;
@@ -142,7 +152,7 @@ int aes_gcm_decrypt(
     }
 
     /* Finalize decryption and verify tag */
-    ret = EVP_DecryptFinal_ex(ctx, plaintext + len, &len);
+    ret = EVP_DecryptFinal_ex(ctx, plaintext + plaintext_len, &len);
 
     /* Clean up */
     EVP_CIPHER_CTX_free(ctx);
@@ -153,7 +163,141 @@ int aes_gcm_decrypt(
         return AES_GCM_SUCCESS;
     } else {
         /* Tag verification failed */
-        memset(plaintext, 0, ct_len);
+        if (ct_len > 0) {
+            memset(plaintext, 0, ct_len);
+        }
         return AES_GCM_ERR_AUTH;
     }
 }
+
+/* Keyed handle: one encrypt and one decrypt context, set up once */
+int aes_gcm_key_init(aes_gcm_key_t *key, const byte_t *key_bytes)
+{
+    if (!key || !key_bytes) {
+        return AES_GCM_ERR_INIT;
+    }
+
+    key->enc = EVP_CIPHER_CTX_new();
+    key->dec = EVP_CIPHER_CTX_new();
+    if (!key->enc || !key->dec) {
+        aes_gcm_key_free(key);
+        return AES_GCM_ERR_INIT;
+    }
+
+    /* Cipher, nonce length and key; the nonce is supplied per message */
+    if (EVP_EncryptInit_ex(key->enc, EVP_aes_128_gcm(), NULL, NULL, NULL) != 1 ||
+        EVP_CIPHER_CTX_ctrl(key->enc, EVP_CTRL_GCM_SET_IVLEN, AES_NONCE_SIZE, NULL) != 1 ||
+        EVP_EncryptInit_ex(key->enc, NULL, NULL, key_bytes, NULL) != 1 ||
+        EVP_DecryptInit_ex(key->dec, EVP_aes_128_gcm(), NULL, NULL, NULL) != 1 ||
+        EVP_CIPHER_CTX_ctrl(key->dec, EVP_CTRL_GCM_SET_IVLEN, AES_NONCE_SIZE, NULL) != 1 ||
+        EVP_DecryptInit_ex(key->dec, NULL, NULL, key_bytes, NULL) != 1) {
+        aes_gcm_key_free(key);
+        return AES_GCM_ERR_INIT;
+    }
+
+    return AES_GCM_SUCCESS;
+}
+
+void aes_gcm_key_free(aes_gcm_key_t *key)
+{
+    if (!key) {
+        return;
+    }
+    EVP_CIPHER_CTX_free(key->enc);
+    EVP_CIPHER_CTX_free(key->dec);
+    key->enc = NULL;
+    key->dec = NULL;
+}
+
+/* AES-128-GCM encryption with a keyed handle */
+int aes_gcm_encrypt_ctx(
+    aes_gcm_key_t *key,
+    const byte_t *nonce,
+    const byte_t *ad, size_t ad_len,
+    const byte_t *plaintext, size_t pt_len,
+    byte_t *ciphertext,
+    byte_t *tag)
+{
+    int len;
+
+    if (!key || !key->enc || !nonce) {
+        return AES_GCM_ERR_INIT;
+    }
+
+    /* New nonce only: keeps the expanded key and GHASH key */
+    if (EVP_EncryptInit_ex(key->enc, NULL, NULL, NULL, nonce) != 1) {
+        return AES_GCM_ERR_INIT;
+    }
+
+    if (ad_len > 0 && ad != NULL) {
+        if (EVP_EncryptUpdate(key->enc, NULL, &len, ad, ad_len) != 1) {
+            return AES_GCM_ERR_INIT;
+        }
+    }
+
+    if (pt_len > 0) {
+        if (EVP_EncryptUpdate(key->enc, ciphertext, &len, plaintext, pt_len) != 1) {
+            return AES_GCM_ERR_INIT;
+        }
+    } else {
+        len = 0;
+    }
+
+    if (EVP_EncryptFinal_ex(key->enc, ciphertext + len, &len) != 1) {
+        return AES_GCM_ERR_INIT;
+    }
+
+    if (EVP_CIPHER_CTX_ctrl(key->enc, EVP_CTRL_GCM_GET_TAG, AES_TAG_SIZE, tag) != 1) {
+        return AES_GCM_ERR_INIT;
+    }
+
+    return AES_GCM_SUCCESS;
+}
+
+/* AES-128-GCM decryption with a keyed handle */
+int aes_gcm_decrypt_ctx(
+    aes_gcm_key_t *key,
+    const byte_t *nonce,
+    const byte_t *ad, size_t ad_len,
+    const byte_t *ciphertext, size_t ct_len,
+    const byte_t *tag,
+    byte_t *plaintext)
+{
+    int len;
+
+    if (!key || !key->dec || !nonce || !tag) {
+        return AES_GCM_ERR_INIT;
+    }
+
+    if (EVP_DecryptInit_ex(key->dec, NULL, NULL, NULL, nonce) != 1) {
+        return AES_GCM_ERR_INIT;
+    }
+
+    if (ad_len > 0 && ad != NULL) {
+        if (EVP_DecryptUpdate(key->dec, NULL, &len, ad, ad_len) != 1) {
+            return AES_GCM_ERR_INIT;
+        }
+    }
+
+    if (ct_len > 0) {
+        if (EVP_DecryptUpdate(key->dec, plaintext, &len, ciphertext, ct_len) != 1) {
+            return AES_GCM_ERR_INIT;
+        }
+    } else {
+        len = 0;
+    }
+
+    if (EVP_CIPHER_CTX_ctrl(key->dec, EVP_CTRL_GCM_SET_TAG, AES_TAG_SIZE, (void *)tag) != 1) {
+        return AES_GCM_ERR_INIT;
+    }
+
+    /* Finalize decryption and verify tag */
+    if (EVP_DecryptFinal_ex(key->dec, plaintext + len, &len) <= 0) {
+        if (ct_len > 0) {
+            memset(plaintext, 0, ct_len);
+        }
+        return AES_GCM_ERR_AUTH;
+    }
+
+    return AES_GCM_SUCCESS;
+}
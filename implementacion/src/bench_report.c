@@ -0,0 +1,207 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_report.h"
+#include "gfrx_cofb.h"
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
+
+#if defined(__clang__)
+#define BENCH_COMPILER __VERSION__
+#elif defined(__GNUC__)
+#define BENCH_COMPILER "gcc " __VERSION__
+#else
+#define BENCH_COMPILER "unknown"
+#endif
+
+/* Set by the Makefile to the CFLAGS the benchmarks were built with. */
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unknown"
+#endif
+
+#define CSV_COLUMNS "test,scheme,bytes,threads,throughput_mbps,latency_us,iterations"
+
+static void cpu_model(char *buf, size_t len) {
+    snprintf(buf, len, "unknown");
+#ifdef __APPLE__
+    size_t n = len;
+    if (sysctlbyname("machdep.cpu.brand_string", buf, &n, NULL, 0) != 0) {
+        snprintf(buf, len, "unknown");
+    }
+#else
+    FILE *fp = fopen("/proc/cpuinfo", "r");
+    if (fp == NULL) {
+        return;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        /* "model name" on x86, "Hardware" or "cpu model" elsewhere */
+        if (strncmp(line, "model name", 10) != 0 && strncmp(line, "Hardware", 8) != 0 &&
+            strncmp(line, "cpu model", 9) != 0) {
+            continue;
+        }
+        char *value = strchr(line, ':');
+        if (value == NULL) {
+            continue;
+        }
+        value++;
+        while (*value == ' ' || *value == '\t') value++;
+        value[strcspn(value, "\n")] = '\0';
+        snprintf(buf, len, "%s", value);
+        break;
+    }
+    fclose(fp);
+#endif
+}
+
+static void json_string(FILE *fp, const char *s) {
+    fputc('"', fp);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fprintf(fp, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(fp, "\\u%04x", c);
+        } else {
+            fputc(c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+static void csv_field(FILE *fp, const char *s) {
+    if (strpbrk(s, ",\"\n") == NULL) {
+        fputs(s, fp);
+        return;
+    }
+    fputc('"', fp);
+    for (; *s; s++) {
+        if (*s == '"') fputc('"', fp);
+        fputc(*s, fp);
+    }
+    fputc('"', fp);
+}
+
+static void write_header(bench_report_t *report, const char *benchmark) {
+    char cpu[256], hostname[256], os[256], date[32];
+    struct utsname un;
+    time_t now = time(NULL);
+    struct tm tm;
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+    cpu_model(cpu, sizeof(cpu));
+    if (gethostname(hostname, sizeof(hostname)) != 0) {
+        snprintf(hostname, sizeof(hostname), "unknown");
+    }
+    hostname[sizeof(hostname) - 1] = '\0';
+    if (uname(&un) == 0) {
+        snprintf(os, sizeof(os), "%s %s %s", un.sysname, un.release, un.machine);
+    } else {
+        snprintf(os, sizeof(os), "unknown");
+    }
+    gmtime_r(&now, &tm);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &tm);
+
+    const char *keys[] = {"benchmark", "date", "hostname", "cpu", "os", "compiler", "cflags", "backend"};
+    const char *values[] = {benchmark, date, hostname, cpu, os, BENCH_COMPILER, BENCH_CFLAGS,
+                            gfrx_backend_name()};
+    size_t nkeys = sizeof(keys) / sizeof(keys[0]);
+
+    if (report->format == BENCH_REPORT_JSON) {
+        fprintf(report->fp, "{\n  \"host\": {\n");
+        for (size_t i = 0; i < nkeys; i++) {
+            fprintf(report->fp, "    \"%s\": ", keys[i]);
+            json_string(report->fp, values[i]);
+            fprintf(report->fp, ",\n");
+        }
+        fprintf(report->fp, "    \"ncpu\": %ld,\n    \"lanes\": %zu\n  },\n  \"results\": [",
+                ncpu, gfrx_backend_lanes());
+    } else {
+        /* Metadata as comment lines, then a plain CSV table */
+        for (size_t i = 0; i < nkeys; i++) {
+            fprintf(report->fp, "# %s: %s\n", keys[i], values[i]);
+        }
+        fprintf(report->fp, "# ncpu: %ld\n# lanes: %zu\n", ncpu, gfrx_backend_lanes());
+        fprintf(report->fp, "%s\n", CSV_COLUMNS);
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--json FILE | --csv FILE]\n", prog);
+}
+
+int bench_report_open_args(bench_report_t *report, const char *benchmark, int argc, char *argv[]) {
+    const char *path = NULL;
+
+    memset(report, 0, sizeof(*report));
+    for (int i = 1; i < argc; i++) {
+        bench_report_format_t format;
+        if (strcmp(argv[i], "--json") == 0) {
+            format = BENCH_REPORT_JSON;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            format = BENCH_REPORT_CSV;
+        } else {
+            usage(argv[0]);
+            return -1;
+        }
+        if (i + 1 >= argc || report->format != BENCH_REPORT_NONE) {
+            usage(argv[0]);
+            return -1;
+        }
+        report->format = format;
+        path = argv[++i];
+    }
+    if (path == NULL) {
+        return 0;
+    }
+
+    report->fp = fopen(path, "w");
+    if (report->fp == NULL) {
+        perror(path);
+        report->format = BENCH_REPORT_NONE;
+        return -1;
+    }
+    write_header(report, benchmark);
+    return 0;
+}
+
+void bench_report_add(bench_report_t *report, const char *test, const char *scheme, size_t bytes,
+                      unsigned threads, double throughput_mbps, double latency_us, size_t iterations) {
+    if (report->fp == NULL) {
+        return;
+    }
+    if (report->format == BENCH_REPORT_JSON) {
+        fprintf(report->fp, "%s\n    {\"test\": ", report->records ? "," : "");
+        json_string(report->fp, test);
+        fprintf(report->fp, ", \"scheme\": ");
+        json_string(report->fp, scheme);
+        fprintf(report->fp, ", \"bytes\": %zu, \"threads\": %u, \"throughput_mbps\": %.4f, "
+                "\"latency_us\": %.6f, \"iterations\": %zu}",
+                bytes, threads, throughput_mbps, latency_us, iterations);
+    } else {
+        csv_field(report->fp, test);
+        fputc(',', report->fp);
+        csv_field(report->fp, scheme);
+        fprintf(report->fp, ",%zu,%u,%.4f,%.6f,%zu\n", bytes, threads, throughput_mbps, latency_us, iterations);
+    }
+    report->records++;
+}
+
+int bench_report_close(bench_report_t *report) {
+    if (report->fp == NULL) {
+        return 0;
+    }
+    if (report->format == BENCH_REPORT_JSON) {
+        fprintf(report->fp, "\n  ]\n}\n");
+    }
+    int failed = ferror(report->fp);
+    if (fclose(report->fp) != 0) {
+        failed = 1;
+    }
+    report->fp = NULL;
+    return failed ? -1 : 0;
+}
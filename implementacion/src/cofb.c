@@ -1,112 +1,93 @@
-#include "../include/gfrx_cofb.h"
+#include "gfrx_internal.h"
 #include <stdio.h>
 #include <stdlib.h>
 
-#define POLY64 0x1B
+#define COFB_PHASE_AD   0
+#define COFB_PHASE_MSG  1
 
-static uint64_t compute_mask(uint64_t delta, int a, int b) {
-    uint64_t mask = delta;
-    for (int i = 0; i < a; i++) {
-        uint64_t msb = mask >> 63;
-        mask <<= 1;
-        if (msb) {
-            mask ^= POLY64;
-        }
-    }
-    if (b == 1) {
-        uint64_t temp = mask;
-        uint64_t msb = mask >> 63;
-        mask <<= 1;
-        if (msb) {
-            mask ^= POLY64;
-        }
-        mask ^= temp;
-    }
-    return mask;
-}
+/*
+ * The chain value Y, message blocks and mask are handled as four
+ * little-endian words end to end; bytes are only touched when reading the
+ * caller's input and writing output. The one-shot mode comes from
+ * cofb_core.h, instantiated here on the inlined GFRX rounds.
+ */
+#define COFB_CORE_NAME(x)        gfrx_cofb_##x
+#define COFB_CORE_CIPHER         gfrx_ctx_t
+#define COFB_CORE_ENCRYPT(c, Y)  gfrx_encrypt_words((c)->round_keys, (Y))
+#define COFB_CORE_EMPTY_BLOCK    1
+#define COFB_CORE_TAG_MASK       0
+#include "cofb_core.h"
 
-static void G_function(const byte_t *Y, byte_t *result) {
-    uint32_t Y1 = ((uint32_t)Y[0]) | ((uint32_t)Y[1] << 8) | 
-                  ((uint32_t)Y[2] << 16) | ((uint32_t)Y[3] << 24);
-    uint32_t Y2 = ((uint32_t)Y[4]) | ((uint32_t)Y[5] << 8) | 
-                  ((uint32_t)Y[6] << 16) | ((uint32_t)Y[7] << 24);
-    uint32_t Y3 = ((uint32_t)Y[8]) | ((uint32_t)Y[9] << 8) | 
-                  ((uint32_t)Y[10] << 16) | ((uint32_t)Y[11] << 24);
-    uint32_t Y4 = ((uint32_t)Y[12]) | ((uint32_t)Y[13] << 8) | 
-                  ((uint32_t)Y[14] << 16) | ((uint32_t)Y[15] << 24);
+/* Streaming state for a new message; ctx->gfrx already holds the key. */
+static void cofb_start(cofb_ctx_t *ctx, const byte_t *nonce) {
+    word32_t Y[4];
+    ctx->delta = gfrx_cofb_start(&ctx->gfrx, nonce, Y);
+    store_block_le(ctx->Y, Y);
     
-    uint32_t G1 = Y2;
-    uint32_t G2 = Y3;
-    uint32_t G3 = Y4;
-    uint32_t G4 = Y4 ^ Y1;
-    
-    result[0] = G1 & 0xFF; result[1] = (G1 >> 8) & 0xFF;
-    result[2] = (G1 >> 16) & 0xFF; result[3] = (G1 >> 24) & 0xFF;
-    result[4] = G2 & 0xFF; result[5] = (G2 >> 8) & 0xFF;
-    result[6] = (G2 >> 16) & 0xFF; result[7] = (G2 >> 24) & 0xFF;
-    result[8] = G3 & 0xFF; result[9] = (G3 >> 8) & 0xFF;
-    result[10] = (G3 >> 16) & 0xFF; result[11] = (G3 >> 24) & 0xFF;
-    result[12] = G4 & 0xFF; result[13] = (G4 >> 8) & 0xFF;
-    result[14] = (G4 >> 16) & 0xFF; result[15] = (G4 >> 24) & 0xFF;
+    ctx->ad_blocks = 0;
+    ctx->msg_blocks = 0;
+    ctx->buf_len = 0;
+    ctx->phase = COFB_PHASE_AD;
 }
 
-static void rho_function(const byte_t *Y, const byte_t *M, byte_t *X, byte_t *C, size_t len) {
-    byte_t G_Y[GFRX_BLOCK_SIZE];
-    G_function(Y, G_Y);
-    
-    for (size_t i = 0; i < len; i++) {
-        X[i] = G_Y[i] ^ M[i];
-    }
-    for (size_t i = len; i < GFRX_BLOCK_SIZE; i++) {
-        X[i] = G_Y[i];
+int cofb_init(cofb_ctx_t *ctx, const byte_t *key, const byte_t *nonce) {
+    if (!ctx || !key || !nonce) {
+        return GFRX_ERR_INVALID;
     }
     
-    if (C != NULL) {
-        for (size_t i = 0; i < len; i++) {
-            C[i] = Y[i] ^ M[i];
-        }
-    }
+    gfrx_init(&ctx->gfrx, key);
+    cofb_start(ctx, nonce);
+    
+    return GFRX_SUCCESS;
 }
 
-static void rho_inverse(const byte_t *Y, const byte_t *C, byte_t *X, byte_t *M, size_t len) {
-    byte_t G_Y[GFRX_BLOCK_SIZE];
-    byte_t M_padded[GFRX_BLOCK_SIZE];
-    G_function(Y, G_Y);
-
-    memset(M_padded, 0, GFRX_BLOCK_SIZE);
-    for (size_t i = 0; i < len; i++) {
-        M_padded[i] = Y[i] ^ C[i];
-        if (M != NULL) {
-            M[i] = M_padded[i];
-        }
+int cofb_init_key(cofb_ctx_t *ctx, const cofb_key_t *key, const byte_t *nonce) {
+    if (!ctx || !key || !nonce) {
+        return GFRX_ERR_INVALID;
     }
+    
+    ctx->gfrx = key->gfrx;
+    cofb_start(ctx, nonce);
+    
+    return GFRX_SUCCESS;
+}
 
-    for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-        X[i] = G_Y[i] ^ M_padded[i];
+int cofb_key_init(cofb_key_t *key, const byte_t *key_bytes) {
+    if (!key || !key_bytes) {
+        return GFRX_ERR_INVALID;
     }
+    return gfrx_init(&key->gfrx, key_bytes);
 }
 
-int cofb_init(cofb_ctx_t *ctx, const byte_t *key, const byte_t *nonce) {
-    if (!ctx || !key || !nonce) {
+int cofb_encrypt_ctx(const cofb_key_t *key, const byte_t *nonce,
+                     const byte_t *ad, size_t ad_len,
+                     const byte_t *plaintext, size_t plaintext_len,
+                     byte_t *ciphertext, byte_t *tag) {
+    
+    if (!key || !nonce) {
         return GFRX_ERR_INVALID;
     }
     
-    gfrx_init(&ctx->gfrx, key);
-    
-    byte_t nonce_block[GFRX_BLOCK_SIZE];
-    memset(nonce_block, 0, GFRX_BLOCK_SIZE);
-    memcpy(nonce_block, nonce, GFRX_NONCE_SIZE);
+    gfrx_cofb_encrypt(&key->gfrx, nonce, ad, ad_len, plaintext, plaintext_len, ciphertext, tag);
     
-    gfrx_encrypt_block(&ctx->gfrx, nonce_block, ctx->Y);
+    return GFRX_SUCCESS;
+}
+
+int cofb_decrypt_ctx(const cofb_key_t *key, const byte_t *nonce,
+                     const byte_t *ad, size_t ad_len,
+                     const byte_t *ciphertext, size_t ciphertext_len,
+                     const byte_t *tag, byte_t *plaintext) {
     
-    uint64_t delta = 0;
-    for (int i = 0; i < 8; i++) {
-        delta |= ((uint64_t)ctx->Y[i]) << (i * 8);
+    if (!key || !nonce) {
+        return GFRX_ERR_INVALID;
     }
-    ctx->delta = delta;
     
-    ctx->ad_blocks = 0;
-    ctx->msg_blocks = 0;
+    if (gfrx_cofb_decrypt(&key->gfrx, nonce, ad, ad_len, ciphertext, ciphertext_len, tag, plaintext) != 0) {
+        if (plaintext != NULL) {
+            secure_zero(plaintext, ciphertext_len);
+        }
+        return GFRX_ERR_AUTH;
+    }
     
     return GFRX_SUCCESS;
 }
@@ -116,137 +97,15 @@ int cofb_encrypt(const byte_t *key, const byte_t *nonce,
                  const byte_t *plaintext, size_t plaintext_len,
                  byte_t *ciphertext, byte_t *tag) {
     
-    cofb_ctx_t ctx;
-    if (cofb_init(&ctx, key, nonce) != GFRX_SUCCESS) {
+    cofb_key_t k;
+    if (cofb_key_init(&k, key) != GFRX_SUCCESS) {
         return GFRX_ERR_INVALID;
     }
     
-    byte_t Y[GFRX_BLOCK_SIZE];
-    memcpy(Y, ctx.Y, GFRX_BLOCK_SIZE);
+    int ret = cofb_encrypt_ctx(&k, nonce, ad, ad_len, plaintext, plaintext_len, ciphertext, tag);
     
-    size_t ad_blocks = 0;
-    if (ad != NULL && ad_len > 0) {
-        size_t remaining = ad_len;
-        size_t offset = 0;
-        
-        while (remaining >= GFRX_BLOCK_SIZE) {
-            byte_t X[GFRX_BLOCK_SIZE];
-            rho_function(Y, ad + offset, X, NULL, GFRX_BLOCK_SIZE);
-            
-            byte_t L[GFRX_BLOCK_SIZE];
-            memset(L, 0, GFRX_BLOCK_SIZE);
-            uint64_t mask = compute_mask(ctx.delta, ad_blocks, 0);
-            for (int i = 0; i < 8; i++) {
-                L[i] = (mask >> (i * 8)) & 0xFF;
-            }
-            
-            for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-                X[i] ^= L[i];
-            }
-            
-            gfrx_encrypt_block(&ctx.gfrx, X, Y);
-            
-            offset += GFRX_BLOCK_SIZE;
-            remaining -= GFRX_BLOCK_SIZE;
-            ad_blocks++;
-        }
-        
-        if (remaining > 0) {
-            byte_t X[GFRX_BLOCK_SIZE];
-            rho_function(Y, ad + offset, X, NULL, remaining);
-            
-            byte_t L[GFRX_BLOCK_SIZE];
-            memset(L, 0, GFRX_BLOCK_SIZE);
-            uint64_t mask = compute_mask(ctx.delta, ad_blocks, 1);
-            for (int i = 0; i < 8; i++) {
-                L[i] = (mask >> (i * 8)) & 0xFF;
-            }
-            
-            for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-                X[i] ^= L[i];
-            }
-            
-            gfrx_encrypt_block(&ctx.gfrx, X, Y);
-            ad_blocks++;
-        }
-    }
-    
-    size_t msg_blocks = 0;
-    if (plaintext != NULL && plaintext_len > 0) {
-        size_t remaining = plaintext_len;
-        size_t offset = 0;
-        
-        while (remaining >= GFRX_BLOCK_SIZE) {
-            byte_t X[GFRX_BLOCK_SIZE];
-            byte_t C[GFRX_BLOCK_SIZE];
-            rho_function(Y, plaintext + offset, X, C, GFRX_BLOCK_SIZE);
-            
-            memcpy(ciphertext + offset, C, GFRX_BLOCK_SIZE);
-            
-            byte_t L[GFRX_BLOCK_SIZE];
-            memset(L, 0, GFRX_BLOCK_SIZE);
-            uint64_t mask = compute_mask(ctx.delta, ad_blocks + msg_blocks, 0);
-            for (int i = 0; i < 8; i++) {
-                L[i] = (mask >> (i * 8)) & 0xFF;
-            }
-            
-            for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-                X[i] ^= L[i];
-            }
-            
-            gfrx_encrypt_block(&ctx.gfrx, X, Y);
-            
-            offset += GFRX_BLOCK_SIZE;
-            remaining -= GFRX_BLOCK_SIZE;
-            msg_blocks++;
-        }
-        
-        if (remaining > 0) {
-            byte_t X[GFRX_BLOCK_SIZE];
-            byte_t C[GFRX_BLOCK_SIZE];
-            rho_function(Y, plaintext + offset, X, C, remaining);
-            
-            memcpy(ciphertext + offset, C, remaining);
-            
-            byte_t L[GFRX_BLOCK_SIZE];
-            memset(L, 0, GFRX_BLOCK_SIZE);
-            uint64_t mask = compute_mask(ctx.delta, ad_blocks + msg_blocks, 1);
-            for (int i = 0; i < 8; i++) {
-                L[i] = (mask >> (i * 8)) & 0xFF;
-            }
-            
-            for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-                X[i] ^= L[i];
-            }
-            
-            gfrx_encrypt_block(&ctx.gfrx, X, Y);
-            msg_blocks++;
-        }
-    } else {
-        byte_t X[GFRX_BLOCK_SIZE];
-        byte_t G_Y[GFRX_BLOCK_SIZE];
-        G_function(Y, G_Y);
-        memcpy(X, G_Y, GFRX_BLOCK_SIZE);
-        
-        byte_t L[GFRX_BLOCK_SIZE];
-        memset(L, 0, GFRX_BLOCK_SIZE);
-        uint64_t mask = compute_mask(ctx.delta, ad_blocks, 1);
-        for (int i = 0; i < 8; i++) {
-            L[i] = (mask >> (i * 8)) & 0xFF;
-        }
-        
-        for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-            X[i] ^= L[i];
-        }
-        
-        gfrx_encrypt_block(&ctx.gfrx, X, Y);
-    }
-    
-    memcpy(tag, Y, GFRX_TAG_SIZE);
-    
-    secure_zero(&ctx, sizeof(cofb_ctx_t));
-    
-    return GFRX_SUCCESS;
+    secure_zero(&k, sizeof(cofb_key_t));
+    return ret;
 }
 
 int cofb_decrypt(const byte_t *key, const byte_t *nonce,
@@ -254,144 +113,189 @@ int cofb_decrypt(const byte_t *key, const byte_t *nonce,
                  const byte_t *ciphertext, size_t ciphertext_len,
                  const byte_t *tag, byte_t *plaintext) {
     
-    cofb_ctx_t ctx;
-    if (cofb_init(&ctx, key, nonce) != GFRX_SUCCESS) {
+    cofb_key_t k;
+    if (cofb_key_init(&k, key) != GFRX_SUCCESS) {
         return GFRX_ERR_INVALID;
     }
     
-    byte_t Y[GFRX_BLOCK_SIZE];
-    memcpy(Y, ctx.Y, GFRX_BLOCK_SIZE);
+    int ret = cofb_decrypt_ctx(&k, nonce, ad, ad_len, ciphertext, ciphertext_len, tag, plaintext);
     
-    size_t ad_blocks = 0;
-    if (ad != NULL && ad_len > 0) {
-        size_t remaining = ad_len;
-        size_t offset = 0;
+    secure_zero(&k, sizeof(cofb_key_t));
+    return ret;
+}
+
+static void cofb_absorb(cofb_ctx_t *ctx, const byte_t *block, int partial) {
+    word32_t Y[4], M[4];
+    load_block_le(Y, ctx->Y);
+    load_block_le(M, block);
+    
+    gfrx_cofb_step(&ctx->gfrx, Y, M, partial ? mask_triple(ctx->delta) : ctx->delta);
+    ctx->delta = mask_double(ctx->delta);
+    
+    store_block_le(ctx->Y, Y);
+}
+
+static void cofb_flush_partial(cofb_ctx_t *ctx) {
+    memset(ctx->buf + ctx->buf_len, 0, GFRX_BLOCK_SIZE - ctx->buf_len);
+    cofb_absorb(ctx, ctx->buf, 1);
+    ctx->buf_len = 0;
+}
+
+static int cofb_stream_ad(cofb_ctx_t *ctx, const byte_t *ad, size_t ad_len) {
+    if (!ctx || (!ad && ad_len > 0) || ctx->phase != COFB_PHASE_AD) {
+        return GFRX_ERR_INVALID;
+    }
+    
+    while (ad_len > 0) {
+        if (ctx->buf_len == 0 && ad_len >= GFRX_BLOCK_SIZE) {
+            cofb_absorb(ctx, ad, 0);
+            ctx->ad_blocks++;
+            ad += GFRX_BLOCK_SIZE;
+            ad_len -= GFRX_BLOCK_SIZE;
+            continue;
+        }
         
-        while (remaining >= GFRX_BLOCK_SIZE) {
-            byte_t X[GFRX_BLOCK_SIZE];
-            rho_function(Y, ad + offset, X, NULL, GFRX_BLOCK_SIZE);
-            
-            byte_t L[GFRX_BLOCK_SIZE];
-            memset(L, 0, GFRX_BLOCK_SIZE);
-            uint64_t mask = compute_mask(ctx.delta, ad_blocks, 0);
-            for (int i = 0; i < 8; i++) {
-                L[i] = (mask >> (i * 8)) & 0xFF;
-            }
-            
-            for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-                X[i] ^= L[i];
-            }
-            
-            gfrx_encrypt_block(&ctx.gfrx, X, Y);
-            
-            offset += GFRX_BLOCK_SIZE;
-            remaining -= GFRX_BLOCK_SIZE;
-            ad_blocks++;
+        size_t n = GFRX_BLOCK_SIZE - ctx->buf_len;
+        if (n > ad_len) {
+            n = ad_len;
         }
+        memcpy(ctx->buf + ctx->buf_len, ad, n);
+        ctx->buf_len += n;
+        ad += n;
+        ad_len -= n;
         
-        if (remaining > 0) {
-            byte_t X[GFRX_BLOCK_SIZE];
-            rho_function(Y, ad + offset, X, NULL, remaining);
-            
-            byte_t L[GFRX_BLOCK_SIZE];
-            memset(L, 0, GFRX_BLOCK_SIZE);
-            uint64_t mask = compute_mask(ctx.delta, ad_blocks, 1);
-            for (int i = 0; i < 8; i++) {
-                L[i] = (mask >> (i * 8)) & 0xFF;
-            }
-            
-            for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-                X[i] ^= L[i];
-            }
-            
-            gfrx_encrypt_block(&ctx.gfrx, X, Y);
-            ad_blocks++;
+        if (ctx->buf_len == GFRX_BLOCK_SIZE) {
+            cofb_absorb(ctx, ctx->buf, 0);
+            ctx->ad_blocks++;
+            ctx->buf_len = 0;
         }
     }
     
-    size_t msg_blocks = 0;
-    if (ciphertext != NULL && ciphertext_len > 0) {
-        size_t remaining = ciphertext_len;
-        size_t offset = 0;
-        
-        while (remaining >= GFRX_BLOCK_SIZE) {
-            byte_t X[GFRX_BLOCK_SIZE];
-            byte_t M[GFRX_BLOCK_SIZE];
-            rho_inverse(Y, ciphertext + offset, X, M, GFRX_BLOCK_SIZE);
-            
-            if (plaintext != NULL) {
-                memcpy(plaintext + offset, M, GFRX_BLOCK_SIZE);
-            }
-            
-            byte_t L[GFRX_BLOCK_SIZE];
-            memset(L, 0, GFRX_BLOCK_SIZE);
-            uint64_t mask = compute_mask(ctx.delta, ad_blocks + msg_blocks, 0);
-            for (int i = 0; i < 8; i++) {
-                L[i] = (mask >> (i * 8)) & 0xFF;
-            }
-            
-            for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-                X[i] ^= L[i];
-            }
-            
-            gfrx_encrypt_block(&ctx.gfrx, X, Y);
-            
-            offset += GFRX_BLOCK_SIZE;
-            remaining -= GFRX_BLOCK_SIZE;
-            msg_blocks++;
+    return GFRX_SUCCESS;
+}
+
+static void cofb_end_ad(cofb_ctx_t *ctx) {
+    if (ctx->phase == COFB_PHASE_AD) {
+        if (ctx->buf_len > 0) {
+            cofb_flush_partial(ctx);
+            ctx->ad_blocks++;
         }
-        
-        if (remaining > 0) {
-            byte_t X[GFRX_BLOCK_SIZE];
-            byte_t M[GFRX_BLOCK_SIZE];
-            rho_inverse(Y, ciphertext + offset, X, M, remaining);
-            
-            if (plaintext != NULL) {
-                memcpy(plaintext + offset, M, remaining);
-            }
-            
-            byte_t L[GFRX_BLOCK_SIZE];
-            memset(L, 0, GFRX_BLOCK_SIZE);
-            uint64_t mask = compute_mask(ctx.delta, ad_blocks + msg_blocks, 1);
-            for (int i = 0; i < 8; i++) {
-                L[i] = (mask >> (i * 8)) & 0xFF;
-            }
-            
+        ctx->phase = COFB_PHASE_MSG;
+    }
+}
+
+/*
+ * C = Y xor M is available as soon as each byte arrives, so output is never
+ * held back; only the X = G(Y) xor M block waits in ctx->buf until it is full.
+ * When decrypting, out may be NULL to authenticate without writing plaintext.
+ */
+static int cofb_stream_msg(cofb_ctx_t *ctx, const byte_t *in, size_t len, byte_t *out, int decrypt) {
+    if (!ctx || ((!in || (!out && !decrypt)) && len > 0)) {
+        return GFRX_ERR_INVALID;
+    }
+    
+    cofb_end_ad(ctx);
+    
+    while (len > 0) {
+        if (ctx->buf_len == 0 && len >= GFRX_BLOCK_SIZE) {
+            byte_t O[GFRX_BLOCK_SIZE];
             for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-                X[i] ^= L[i];
+                O[i] = ctx->Y[i] ^ in[i];
+            }
+            cofb_absorb(ctx, decrypt ? O : in, 0);
+            ctx->msg_blocks++;
+            if (out != NULL) {
+                memcpy(out, O, GFRX_BLOCK_SIZE);
+                out += GFRX_BLOCK_SIZE;
             }
-            
-            gfrx_encrypt_block(&ctx.gfrx, X, Y);
-            msg_blocks++;
+            in += GFRX_BLOCK_SIZE;
+            len -= GFRX_BLOCK_SIZE;
+            continue;
         }
-    } else {
-        byte_t X[GFRX_BLOCK_SIZE];
-        byte_t G_Y[GFRX_BLOCK_SIZE];
-        G_function(Y, G_Y);
-        memcpy(X, G_Y, GFRX_BLOCK_SIZE);
         
-        byte_t L[GFRX_BLOCK_SIZE];
-        memset(L, 0, GFRX_BLOCK_SIZE);
-        uint64_t mask = compute_mask(ctx.delta, ad_blocks, 1);
-        for (int i = 0; i < 8; i++) {
-            L[i] = (mask >> (i * 8)) & 0xFF;
+        while (len > 0 && ctx->buf_len < GFRX_BLOCK_SIZE) {
+            byte_t o = ctx->Y[ctx->buf_len] ^ *in;
+            ctx->buf[ctx->buf_len++] = decrypt ? o : *in;
+            if (out != NULL) {
+                *out++ = o;
+            }
+            in++;
+            len--;
         }
         
-        for (size_t i = 0; i < GFRX_BLOCK_SIZE; i++) {
-            X[i] ^= L[i];
+        if (ctx->buf_len == GFRX_BLOCK_SIZE) {
+            cofb_absorb(ctx, ctx->buf, 0);
+            ctx->msg_blocks++;
+            ctx->buf_len = 0;
         }
-        
-        gfrx_encrypt_block(&ctx.gfrx, X, Y);
     }
     
-    if (secure_compare(Y, tag, GFRX_TAG_SIZE) != 0) {
-        if (plaintext != NULL) {
-            secure_zero(plaintext, ciphertext_len);
-        }
-        secure_zero(&ctx, sizeof(cofb_ctx_t));
-        return GFRX_ERR_AUTH;
+    return GFRX_SUCCESS;
+}
+
+static void cofb_stream_final(cofb_ctx_t *ctx) {
+    cofb_end_ad(ctx);
+    
+    if (ctx->buf_len > 0) {
+        cofb_flush_partial(ctx);
+        ctx->msg_blocks++;
+    } else if (ctx->msg_blocks == 0) {
+        cofb_flush_partial(ctx);
+    }
+}
+
+int cofb_encrypt_init(cofb_ctx_t *ctx, const byte_t *key, const byte_t *nonce) {
+    return cofb_init(ctx, key, nonce);
+}
+
+int cofb_encrypt_init_key(cofb_ctx_t *ctx, const cofb_key_t *key, const byte_t *nonce) {
+    return cofb_init_key(ctx, key, nonce);
+}
+
+int cofb_encrypt_update_ad(cofb_ctx_t *ctx, const byte_t *ad, size_t ad_len) {
+    return cofb_stream_ad(ctx, ad, ad_len);
+}
+
+int cofb_encrypt_update(cofb_ctx_t *ctx, const byte_t *plaintext, size_t plaintext_len, byte_t *ciphertext) {
+    return cofb_stream_msg(ctx, plaintext, plaintext_len, ciphertext, 0);
+}
+
+int cofb_encrypt_final(cofb_ctx_t *ctx, byte_t *tag) {
+    if (!ctx || !tag) {
+        return GFRX_ERR_INVALID;
     }
     
-    secure_zero(&ctx, sizeof(cofb_ctx_t));
+    cofb_stream_final(ctx);
+    memcpy(tag, ctx->Y, GFRX_TAG_SIZE);
+    
+    secure_zero(ctx, sizeof(cofb_ctx_t));
     return GFRX_SUCCESS;
 }
+
+int cofb_decrypt_init(cofb_ctx_t *ctx, const byte_t *key, const byte_t *nonce) {
+    return cofb_init(ctx, key, nonce);
+}
+
+int cofb_decrypt_init_key(cofb_ctx_t *ctx, const cofb_key_t *key, const byte_t *nonce) {
+    return cofb_init_key(ctx, key, nonce);
+}
+
+int cofb_decrypt_update_ad(cofb_ctx_t *ctx, const byte_t *ad, size_t ad_len) {
+    return cofb_stream_ad(ctx, ad, ad_len);
+}
+
+int cofb_decrypt_update(cofb_ctx_t *ctx, const byte_t *ciphertext, size_t ciphertext_len, byte_t *plaintext) {
+    return cofb_stream_msg(ctx, ciphertext, ciphertext_len, plaintext, 1);
+}
+
+int cofb_decrypt_final(cofb_ctx_t *ctx, const byte_t *tag) {
+    if (!ctx || !tag) {
+        return GFRX_ERR_INVALID;
+    }
+    
+    cofb_stream_final(ctx);
+    int diff = secure_compare(ctx->Y, tag, GFRX_TAG_SIZE);
+    
+    secure_zero(ctx, sizeof(cofb_ctx_t));
+    return diff != 0 ? GFRX_ERR_AUTH : GFRX_SUCCESS;
+}
@@ -0,0 +1,218 @@
+#include "gfrx_internal.h"
+
+/*
+ * Multi-message COFB. Each message is one sequential chain (nonce block,
+ * AD blocks, message blocks), but chains of different messages are
+ * independent, so up to COFB_BATCH_LANES of them advance in lockstep: every
+ * iteration builds one cipher input per active lane and encrypts them all
+ * with one call to the dispatched gfrx_encrypt_blocks(). When a chain
+ * finishes, its lane is retired and immediately refilled with the next
+ * pending message, so mixed lengths keep the lanes busy.
+ */
+
+#define COFB_BATCH_LANES 16
+
+enum {
+    STAGE_NONCE,
+    STAGE_AD,
+    STAGE_MSG,
+    STAGE_EMPTY,
+    STAGE_DONE
+};
+
+typedef struct {
+    size_t idx;
+    int stage;
+    int last;
+    size_t offset;
+    word32_t Y[4];
+    uint64_t delta;
+} cofb_lane_t;
+
+static void lane_start(cofb_lane_t *lane, size_t idx) {
+    lane->idx = idx;
+    lane->stage = STAGE_NONCE;
+    lane->last = 0;
+    lane->offset = 0;
+}
+
+static int next_stage_after_ad(const cofb_batch_msg_t *m) {
+    return (m->in != NULL && m->in_len > 0) ? STAGE_MSG : STAGE_EMPTY;
+}
+
+/* Builds the next cipher input for this lane and emits any output bytes it determines. */
+static void lane_prepare(cofb_lane_t *lane, const cofb_batch_msg_t *m, int decrypt, byte_t *X_bytes) {
+    word32_t X[4], M[4];
+
+    switch (lane->stage) {
+    case STAGE_NONCE:
+        X[0] = load32_le(m->nonce);
+        X[1] = load32_le(m->nonce + 4);
+        X[2] = 0;
+        X[3] = 0;
+        break;
+
+    case STAGE_AD: {
+        size_t n = m->ad_len - lane->offset;
+        byte_t buf[GFRX_BLOCK_SIZE] = {0};
+        if (n > GFRX_BLOCK_SIZE) {
+            n = GFRX_BLOCK_SIZE;
+        }
+        memcpy(buf, m->ad + lane->offset, n);
+        load_block_le(M, buf);
+        lane->offset += n;
+        lane->last = (lane->offset == m->ad_len);
+        cofb_feedback(X, lane->Y, M, n < GFRX_BLOCK_SIZE ? mask_triple(lane->delta) : lane->delta);
+        break;
+    }
+
+    case STAGE_MSG: {
+        size_t n = m->in_len - lane->offset;
+        byte_t buf[GFRX_BLOCK_SIZE] = {0};
+        byte_t Y_bytes[GFRX_BLOCK_SIZE];
+        if (n > GFRX_BLOCK_SIZE) {
+            n = GFRX_BLOCK_SIZE;
+        }
+        store_block_le(Y_bytes, lane->Y);
+        const byte_t *in = m->in + lane->offset;
+        byte_t *out = (m->out != NULL) ? m->out + lane->offset : NULL;
+        for (size_t i = 0; i < n; i++) {
+            byte_t o = Y_bytes[i] ^ in[i];
+            buf[i] = decrypt ? o : in[i];
+            if (out != NULL) {
+                out[i] = o;
+            }
+        }
+        load_block_le(M, buf);
+        lane->offset += n;
+        lane->last = (lane->offset == m->in_len);
+        cofb_feedback(X, lane->Y, M, n < GFRX_BLOCK_SIZE ? mask_triple(lane->delta) : lane->delta);
+        break;
+    }
+
+    default: {
+        static const word32_t empty[4] = {0, 0, 0, 0};
+        cofb_feedback(X, lane->Y, empty, mask_triple(lane->delta));
+        break;
+    }
+    }
+
+    store_block_le(X_bytes, X);
+}
+
+/* Takes the cipher output for this lane and advances its stage. */
+static void lane_absorb(cofb_lane_t *lane, const cofb_batch_msg_t *m, const byte_t *Y_bytes) {
+    load_block_le(lane->Y, Y_bytes);
+
+    switch (lane->stage) {
+    case STAGE_NONCE:
+        lane->delta = (uint64_t)lane->Y[0] | ((uint64_t)lane->Y[1] << 32);
+        lane->offset = 0;
+        lane->stage = (m->ad != NULL && m->ad_len > 0) ? STAGE_AD : next_stage_after_ad(m);
+        break;
+
+    case STAGE_AD:
+        lane->delta = mask_double(lane->delta);
+        if (lane->last) {
+            lane->offset = 0;
+            lane->stage = next_stage_after_ad(m);
+        }
+        break;
+
+    case STAGE_MSG:
+        lane->delta = mask_double(lane->delta);
+        if (lane->last) {
+            lane->stage = STAGE_DONE;
+        }
+        break;
+
+    default:
+        lane->stage = STAGE_DONE;
+        break;
+    }
+}
+
+static int cofb_batch_run(const cofb_key_t *key, const cofb_batch_msg_t *msgs, size_t count,
+                          int decrypt, uint8_t *auth_bitmap) {
+    if (!key || (!msgs && count > 0)) {
+        return GFRX_ERR_INVALID;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const cofb_batch_msg_t *m = &msgs[i];
+        if (!m->nonce || !m->tag || (m->in_len > 0 && m->in != NULL && m->out == NULL && !decrypt)) {
+            return GFRX_ERR_INVALID;
+        }
+    }
+
+    if (auth_bitmap != NULL) {
+        memset(auth_bitmap, 0, (count + 7) / 8);
+    }
+
+    cofb_lane_t lanes[COFB_BATCH_LANES];
+    byte_t X[COFB_BATCH_LANES * GFRX_BLOCK_SIZE];
+    byte_t Y[COFB_BATCH_LANES * GFRX_BLOCK_SIZE];
+    size_t active = 0;
+    size_t next = 0;
+    int all_ok = 1;
+
+    while (active < COFB_BATCH_LANES && next < count) {
+        lane_start(&lanes[active++], next++);
+    }
+
+    while (active > 0) {
+        for (size_t l = 0; l < active; l++) {
+            lane_prepare(&lanes[l], &msgs[lanes[l].idx], decrypt, X + l * GFRX_BLOCK_SIZE);
+        }
+
+        gfrx_encrypt_blocks(&key->gfrx, X, Y, active);
+
+        size_t l = 0;
+        while (l < active) {
+            cofb_lane_t *lane = &lanes[l];
+            const cofb_batch_msg_t *m = &msgs[lane->idx];
+            lane_absorb(lane, m, Y + l * GFRX_BLOCK_SIZE);
+
+            if (lane->stage != STAGE_DONE) {
+                l++;
+                continue;
+            }
+
+            byte_t tag[GFRX_TAG_SIZE];
+            store_block_le(tag, lane->Y);
+            if (!decrypt) {
+                memcpy(m->tag, tag, GFRX_TAG_SIZE);
+            } else if (secure_compare(tag, m->tag, GFRX_TAG_SIZE) == 0) {
+                if (auth_bitmap != NULL) {
+                    auth_bitmap[lane->idx / 8] |= (uint8_t)(1u << (lane->idx % 8));
+                }
+            } else {
+                all_ok = 0;
+                if (m->out != NULL && m->in_len > 0) {
+                    secure_zero(m->out, m->in_len);
+                }
+            }
+
+            /* Refill in place, or move the last active lane (and its block) into this slot. */
+            if (next < count) {
+                lane_start(lane, next++);
+                l++;
+            } else {
+                active--;
+                if (l != active) {
+                    lanes[l] = lanes[active];
+                    memcpy(Y + l * GFRX_BLOCK_SIZE, Y + active * GFRX_BLOCK_SIZE, GFRX_BLOCK_SIZE);
+                }
+            }
+        }
+    }
+
+    return all_ok ? GFRX_SUCCESS : GFRX_ERR_AUTH;
+}
+
+int cofb_encrypt_batch(const cofb_key_t *key, const cofb_batch_msg_t *msgs, size_t count) {
+    return cofb_batch_run(key, msgs, count, 0, NULL);
+}
+
+int cofb_decrypt_batch(const cofb_key_t *key, const cofb_batch_msg_t *msgs, size_t count, uint8_t *auth_bitmap) {
+    return cofb_batch_run(key, msgs, count, 1, auth_bitmap);
+}
@@ -0,0 +1,358 @@
+/*
+ * COFB mode shared by GFRX+COFB (cofb.c) and GIFT-COFB (gift_cofb.c); not
+ * installed.
+ *
+ * The first part is the word-level toolkit (little-endian loads, mask
+ * arithmetic, the G feedback) also used by the batch and streaming code.
+ * The second part is the one-shot mode itself, instantiated once per block
+ * cipher so the cipher call is direct and inlinable. Define before
+ * including this header a second time:
+ *
+ *   COFB_CORE_NAME(x)          name of each generated function
+ *   COFB_CORE_CIPHER           block cipher context type
+ *   COFB_CORE_ENCRYPT(ctx, Y)  encrypt Y (four little-endian words) in place
+ *   COFB_CORE_EMPTY_BLOCK      1: an empty message is absorbed as one zero
+ *                              block with mask 3 * delta (GFRX+COFB)
+ *   COFB_CORE_TAG_MASK         1: tag = Y ^ (3 * 2^n * delta), n = blocks
+ *                              absorbed (GIFT-COFB)
+ */
+
+#ifndef COFB_CORE_H
+#define COFB_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define COFB_CORE_BLOCK 16
+
+static inline uint32_t load32_le(const uint8_t *p) {
+    return ((uint32_t)p[0]) | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store32_le(uint8_t *p, uint32_t w) {
+    p[0] = (w >> 0) & 0xFF;
+    p[1] = (w >> 8) & 0xFF;
+    p[2] = (w >> 16) & 0xFF;
+    p[3] = (w >> 24) & 0xFF;
+}
+
+static inline void load_block_le(uint32_t *w, const uint8_t *p) {
+    w[0] = load32_le(p + 0);
+    w[1] = load32_le(p + 4);
+    w[2] = load32_le(p + 8);
+    w[3] = load32_le(p + 12);
+}
+
+static inline void store_block_le(uint8_t *p, const uint32_t *w) {
+    store32_le(p + 0, w[0]);
+    store32_le(p + 4, w[1]);
+    store32_le(p + 8, w[2]);
+    store32_le(p + 12, w[3]);
+}
+
+static inline void load_partial(uint32_t *w, const uint8_t *p, size_t len) {
+    uint8_t buf[COFB_CORE_BLOCK] = {0};
+    memcpy(buf, p, len);
+    load_block_le(w, buf);
+}
+
+static inline void store_partial(uint8_t *p, const uint32_t *w, size_t len) {
+    uint8_t buf[COFB_CORE_BLOCK];
+    store_block_le(buf, w);
+    memcpy(p, buf, len);
+}
+
+#define POLY64 0x1B
+
+/* COFB mask update: multiply delta by x (doubling) or by x+1 (tripling) in GF(2^64). */
+static inline uint64_t mask_double(uint64_t mask) {
+    return (mask << 1) ^ ((0 - (mask >> 63)) & POLY64);
+}
+
+static inline uint64_t mask_triple(uint64_t mask) {
+    return mask_double(mask) ^ mask;
+}
+
+/*
+ * COFB feedback X = G(Y) ^ M ^ (mask || 0^64), with
+ * G(Y1, Y2, Y3, Y4) = (Y2, Y3, Y4, Y4 ^ Y1): a word rotation plus one XOR.
+ */
+static inline void cofb_feedback(uint32_t *X, const uint32_t *Y, const uint32_t *M, uint64_t mask) {
+    uint32_t y0 = Y[0];
+    X[0] = Y[1] ^ M[0] ^ (uint32_t)mask;
+    X[1] = Y[2] ^ M[1] ^ (uint32_t)(mask >> 32);
+    X[2] = Y[3] ^ M[2];
+    X[3] = Y[3] ^ y0 ^ M[3];
+}
+
+#endif /* COFB_CORE_H */
+
+#ifdef COFB_CORE_ENCRYPT
+
+/* One COFB step: X = G(Y) ^ M ^ mask, Y = E_K(X). */
+static inline void COFB_CORE_NAME(step)(const COFB_CORE_CIPHER *cipher, uint32_t *Y,
+                                        const uint32_t *M, uint64_t mask) {
+    cofb_feedback(Y, Y, M, mask);
+    COFB_CORE_ENCRYPT(cipher, Y);
+}
+
+/* Y = E_K(N || 0^64), delta = first 64 bits of Y. */
+static inline uint64_t COFB_CORE_NAME(start)(const COFB_CORE_CIPHER *cipher, const uint8_t *nonce,
+                                             uint32_t *Y) {
+    Y[0] = load32_le(nonce);
+    Y[1] = load32_le(nonce + 4);
+    Y[2] = 0;
+    Y[3] = 0;
+    COFB_CORE_ENCRYPT(cipher, Y);
+    return (uint64_t)Y[0] | ((uint64_t)Y[1] << 32);
+}
+
+/* Associated data; a final partial block is zero-padded and takes mask 3 * delta. */
+static inline uint64_t COFB_CORE_NAME(absorb_ad)(const COFB_CORE_CIPHER *cipher, uint32_t *Y,
+                                                 uint64_t delta, const uint8_t *ad, size_t ad_len) {
+    uint32_t A[4];
+
+    while (ad_len >= COFB_CORE_BLOCK) {
+        load_block_le(A, ad);
+        COFB_CORE_NAME(step)(cipher, Y, A, delta);
+        delta = mask_double(delta);
+        ad += COFB_CORE_BLOCK;
+        ad_len -= COFB_CORE_BLOCK;
+    }
+
+    if (ad_len > 0) {
+        load_partial(A, ad, ad_len);
+        COFB_CORE_NAME(step)(cipher, Y, A, mask_triple(delta));
+        delta = mask_double(delta);
+    }
+
+    return delta;
+}
+
+static inline uint64_t COFB_CORE_NAME(absorb_empty)(const COFB_CORE_CIPHER *cipher, uint32_t *Y,
+                                                    uint64_t delta) {
+#if COFB_CORE_EMPTY_BLOCK
+    static const uint32_t empty[4] = {0, 0, 0, 0};
+    COFB_CORE_NAME(step)(cipher, Y, empty, mask_triple(delta));
+    delta = mask_double(delta);
+#else
+    (void)cipher;
+    (void)Y;
+#endif
+    return delta;
+}
+
+static inline void COFB_CORE_NAME(tag)(uint32_t *Y, uint64_t delta) {
+#if COFB_CORE_TAG_MASK
+    uint64_t mask = mask_triple(delta);
+    Y[0] ^= (uint32_t)mask;
+    Y[1] ^= (uint32_t)(mask >> 32);
+#else
+    (void)Y;
+    (void)delta;
+#endif
+}
+
+/* One full message block: C = Y ^ M, then absorb M with mask delta. */
+static inline uint64_t COFB_CORE_NAME(encrypt_block)(const COFB_CORE_CIPHER *cipher, uint32_t *Y,
+                                                     uint64_t delta, const uint8_t *in, uint8_t *out) {
+    uint32_t M[4], C[4];
+
+    load_block_le(M, in);
+    for (int i = 0; i < 4; i++) {
+        C[i] = Y[i] ^ M[i];
+    }
+    store_block_le(out, C);
+
+    COFB_CORE_NAME(step)(cipher, Y, M, delta);
+    return mask_double(delta);
+}
+
+/* Last message block of 1..16 bytes; a partial one is zero-padded and takes 3 * delta. */
+static inline uint64_t COFB_CORE_NAME(encrypt_last)(const COFB_CORE_CIPHER *cipher, uint32_t *Y,
+                                                    uint64_t delta, const uint8_t *in, size_t len,
+                                                    uint8_t *out) {
+    uint32_t M[4], C[4];
+
+    if (len == COFB_CORE_BLOCK) {
+        return COFB_CORE_NAME(encrypt_block)(cipher, Y, delta, in, out);
+    }
+
+    load_partial(M, in, len);
+    for (int i = 0; i < 4; i++) {
+        C[i] = Y[i] ^ M[i];
+    }
+    store_partial(out, C, len);
+
+    COFB_CORE_NAME(step)(cipher, Y, M, mask_triple(delta));
+    return mask_double(delta);
+}
+
+static inline uint64_t COFB_CORE_NAME(decrypt_block)(const COFB_CORE_CIPHER *cipher, uint32_t *Y,
+                                                     uint64_t delta, const uint8_t *in, uint8_t *out) {
+    uint32_t M[4], C[4];
+
+    load_block_le(C, in);
+    for (int i = 0; i < 4; i++) {
+        M[i] = Y[i] ^ C[i];
+    }
+    if (out != NULL) {
+        store_block_le(out, M);
+    }
+
+    COFB_CORE_NAME(step)(cipher, Y, M, delta);
+    return mask_double(delta);
+}
+
+static inline uint64_t COFB_CORE_NAME(decrypt_last)(const COFB_CORE_CIPHER *cipher, uint32_t *Y,
+                                                    uint64_t delta, const uint8_t *in, size_t len,
+                                                    uint8_t *out) {
+    uint32_t M[4];
+
+    if (len == COFB_CORE_BLOCK) {
+        return COFB_CORE_NAME(decrypt_block)(cipher, Y, delta, in, out);
+    }
+
+    /* M is Y ^ C on the received bytes and zero beyond them */
+    uint8_t M_padded[COFB_CORE_BLOCK] = {0};
+    uint8_t Y_bytes[COFB_CORE_BLOCK];
+    store_block_le(Y_bytes, Y);
+    for (size_t i = 0; i < len; i++) {
+        M_padded[i] = Y_bytes[i] ^ in[i];
+    }
+    if (out != NULL) {
+        memcpy(out, M_padded, len);
+    }
+
+    load_block_le(M, M_padded);
+    COFB_CORE_NAME(step)(cipher, Y, M, mask_triple(delta));
+    return mask_double(delta);
+}
+
+/*
+ * Message blocks. The last block (1..16 bytes) is always the final case of
+ * the switch, and messages of up to four blocks jump straight into the
+ * unrolled sequence without any loop; longer ones run the loop down to
+ * three full blocks and fall into it.
+ */
+static void COFB_CORE_NAME(encrypt)(const COFB_CORE_CIPHER *cipher, const uint8_t *nonce,
+                                    const uint8_t *ad, size_t ad_len,
+                                    const uint8_t *plaintext, size_t plaintext_len,
+                                    uint8_t *ciphertext, uint8_t *tag) {
+    uint32_t Y[4];
+    uint64_t delta = COFB_CORE_NAME(start)(cipher, nonce, Y);
+
+    if (ad != NULL && ad_len > 0) {
+        delta = COFB_CORE_NAME(absorb_ad)(cipher, Y, delta, ad, ad_len);
+    }
+
+    if (plaintext != NULL && plaintext_len > 0) {
+        size_t full = (plaintext_len - 1) / COFB_CORE_BLOCK;
+        size_t last = plaintext_len - full * COFB_CORE_BLOCK;
+
+        switch (full) {
+        default:
+            for (; full > 3; full--) {
+                delta = COFB_CORE_NAME(encrypt_block)(cipher, Y, delta, plaintext, ciphertext);
+                plaintext += COFB_CORE_BLOCK;
+                ciphertext += COFB_CORE_BLOCK;
+            }
+            /* fall through */
+        case 3:
+            delta = COFB_CORE_NAME(encrypt_block)(cipher, Y, delta, plaintext, ciphertext);
+            plaintext += COFB_CORE_BLOCK;
+            ciphertext += COFB_CORE_BLOCK;
+            /* fall through */
+        case 2:
+            delta = COFB_CORE_NAME(encrypt_block)(cipher, Y, delta, plaintext, ciphertext);
+            plaintext += COFB_CORE_BLOCK;
+            ciphertext += COFB_CORE_BLOCK;
+            /* fall through */
+        case 1:
+            delta = COFB_CORE_NAME(encrypt_block)(cipher, Y, delta, plaintext, ciphertext);
+            plaintext += COFB_CORE_BLOCK;
+            ciphertext += COFB_CORE_BLOCK;
+            /* fall through */
+        case 0:
+            delta = COFB_CORE_NAME(encrypt_last)(cipher, Y, delta, plaintext, last, ciphertext);
+            break;
+        }
+    } else {
+        delta = COFB_CORE_NAME(absorb_empty)(cipher, Y, delta);
+    }
+
+    COFB_CORE_NAME(tag)(Y, delta);
+    store_block_le(tag, Y);
+}
+
+/*
+ * Writes the plaintext (if plaintext is not NULL) and returns nonzero when
+ * the tag does not match; wiping the plaintext is left to the caller.
+ */
+static int COFB_CORE_NAME(decrypt)(const COFB_CORE_CIPHER *cipher, const uint8_t *nonce,
+                                   const uint8_t *ad, size_t ad_len,
+                                   const uint8_t *ciphertext, size_t ciphertext_len,
+                                   const uint8_t *tag, uint8_t *plaintext) {
+    uint32_t Y[4];
+    uint64_t delta = COFB_CORE_NAME(start)(cipher, nonce, Y);
+
+    if (ad != NULL && ad_len > 0) {
+        delta = COFB_CORE_NAME(absorb_ad)(cipher, Y, delta, ad, ad_len);
+    }
+
+    if (ciphertext != NULL && ciphertext_len > 0) {
+        size_t full = (ciphertext_len - 1) / COFB_CORE_BLOCK;
+        size_t last = ciphertext_len - full * COFB_CORE_BLOCK;
+        uint8_t *out = plaintext;
+
+        switch (full) {
+        default:
+            for (; full > 3; full--) {
+                delta = COFB_CORE_NAME(decrypt_block)(cipher, Y, delta, ciphertext, out);
+                ciphertext += COFB_CORE_BLOCK;
+                out = out != NULL ? out + COFB_CORE_BLOCK : NULL;
+            }
+            /* fall through */
+        case 3:
+            delta = COFB_CORE_NAME(decrypt_block)(cipher, Y, delta, ciphertext, out);
+            ciphertext += COFB_CORE_BLOCK;
+            out = out != NULL ? out + COFB_CORE_BLOCK : NULL;
+            /* fall through */
+        case 2:
+            delta = COFB_CORE_NAME(decrypt_block)(cipher, Y, delta, ciphertext, out);
+            ciphertext += COFB_CORE_BLOCK;
+            out = out != NULL ? out + COFB_CORE_BLOCK : NULL;
+            /* fall through */
+        case 1:
+            delta = COFB_CORE_NAME(decrypt_block)(cipher, Y, delta, ciphertext, out);
+            ciphertext += COFB_CORE_BLOCK;
+            out = out != NULL ? out + COFB_CORE_BLOCK : NULL;
+            /* fall through */
+        case 0:
+            delta = COFB_CORE_NAME(decrypt_last)(cipher, Y, delta, ciphertext, last, out);
+            break;
+        }
+    } else {
+        delta = COFB_CORE_NAME(absorb_empty)(cipher, Y, delta);
+    }
+
+    COFB_CORE_NAME(tag)(Y, delta);
+
+    uint8_t computed[COFB_CORE_BLOCK];
+    int diff = 0;
+    store_block_le(computed, Y);
+    for (size_t i = 0; i < COFB_CORE_BLOCK; i++) {
+        diff |= computed[i] ^ tag[i];
+    }
+    return diff;
+}
+
+#undef COFB_CORE_NAME
+#undef COFB_CORE_CIPHER
+#undef COFB_CORE_ENCRYPT
+#undef COFB_CORE_EMPTY_BLOCK
+#undef COFB_CORE_TAG_MASK
+
+#endif /* COFB_CORE_ENCRYPT */
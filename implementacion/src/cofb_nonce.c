@@ -0,0 +1,86 @@
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#define HAVE_ARC4RANDOM 1       /* needs the default (non-POSIX) namespace */
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "gfrx_internal.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef __linux__
+#include <sys/random.h>
+#endif
+
+/*
+ * COFB needs nonces that never repeat under one key; they do not have to be
+ * unpredictable. A counter guarantees that directly, whereas random or
+ * PRF-derived 64-bit nonces collide after about 2^32 messages. The random
+ * starting point keeps independent processes sharing a key on disjoint
+ * ranges with high probability.
+ */
+
+/* getrandom() on Linux, arc4random_buf() on macOS and the BSDs, else /dev/urandom. */
+static int read_seed(uint64_t *seed) {
+    byte_t buf[8];
+    size_t got = 0;
+
+#if defined(HAVE_ARC4RANDOM)
+    arc4random_buf(buf, sizeof(buf));
+    got = sizeof(buf);
+#elif defined(__linux__)
+    while (got < sizeof(buf)) {
+        ssize_t n = getrandom(buf + got, sizeof(buf) - got, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        got += (size_t)n;
+    }
+#endif
+    if (got < sizeof(buf)) {
+        /* No getrandom() (old kernel or other system): one read of /dev/urandom. */
+        FILE *f = fopen("/dev/urandom", "rb");
+        got = f ? fread(buf, 1, sizeof(buf), f) : 0;
+        if (f) {
+            fclose(f);
+        }
+        if (got != sizeof(buf)) {
+            return GFRX_ERR_INVALID;
+        }
+    }
+    *seed = (uint64_t)load32_le(buf) | ((uint64_t)load32_le(buf + 4) << 32);
+    secure_zero(buf, sizeof(buf));
+    return GFRX_SUCCESS;
+}
+
+int cofb_nonce_init(cofb_nonce_gen_t *gen) {
+    uint64_t seed;
+    if (!gen || read_seed(&seed) != GFRX_SUCCESS) {
+        return GFRX_ERR_INVALID;
+    }
+    cofb_nonce_init_counter(gen, seed);
+    return GFRX_SUCCESS;
+}
+
+void cofb_nonce_init_counter(cofb_nonce_gen_t *gen, uint64_t start) {
+    __atomic_store_n(&gen->next, start, __ATOMIC_RELAXED);
+}
+
+static void store_nonce(byte_t *nonce, uint64_t value) {
+    store32_le(nonce, (word32_t)value);
+    store32_le(nonce + 4, (word32_t)(value >> 32));
+}
+
+void cofb_nonce_next(cofb_nonce_gen_t *gen, byte_t *nonce) {
+    store_nonce(nonce, __atomic_fetch_add(&gen->next, 1, __ATOMIC_RELAXED));
+}
+
+void cofb_nonce_next_n(cofb_nonce_gen_t *gen, byte_t *nonces, size_t count) {
+    uint64_t first = __atomic_fetch_add(&gen->next, (uint64_t)count, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < count; i++) {
+        store_nonce(nonces + i * GFRX_NONCE_SIZE, first + i);
+    }
+}
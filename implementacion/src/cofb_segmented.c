@@ -0,0 +1,222 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "gfrx_internal.h"
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+ * Segmented (STREAM-style) COFB. The message is cut into fixed-size
+ * segments and each one is an independent cofb_encrypt_ctx() call under
+ * its own nonce, so segments can be encrypted on different cores. The
+ * output is C_0 || T_0 || C_1 || T_1 || ... || C_last || T_last.
+ *
+ * Segment nonces are E_K(N || i || 0x80000000 | last) truncated to 64 bits.
+ * The top bit keeps these inputs apart from COFB's own E_K(N || 0^64), and
+ * binding the last flag means truncating or extending the segment list
+ * makes the final tag fail. Being truncated PRF outputs, they can collide,
+ * hence the per-key budget COFB_SEGMENTS_PER_KEY in gfrx_cofb.h.
+ */
+
+#define SEG_DOMAIN 0x80000000u
+
+int cofb_segment_nonce(const cofb_key_t *key, const byte_t *nonce, uint64_t index, int last,
+                       byte_t *segment_nonce) {
+    if (!key || !nonce || !segment_nonce || index > 0xFFFFFFFFu) {
+        return GFRX_ERR_INVALID;
+    }
+
+    word32_t w[4];
+    w[0] = load32_le(nonce);
+    w[1] = load32_le(nonce + 4);
+    w[2] = (word32_t)index;
+    w[3] = SEG_DOMAIN | (last ? 1u : 0u);
+    gfrx_encrypt_words(key->gfrx.round_keys, w);
+
+    store32_le(segment_nonce, w[0]);
+    store32_le(segment_nonce + 4, w[1]);
+    return GFRX_SUCCESS;
+}
+
+size_t cofb_segment_count(size_t plaintext_len, size_t segment_size) {
+    if (segment_size == 0) {
+        return 0;
+    }
+    return plaintext_len == 0 ? 1 : (plaintext_len + segment_size - 1) / segment_size;
+}
+
+size_t cofb_segmented_len(size_t plaintext_len, size_t segment_size) {
+    return plaintext_len + cofb_segment_count(plaintext_len, segment_size) * GFRX_TAG_SIZE;
+}
+
+int cofb_segmented_layout(size_t ciphertext_len, size_t segment_size,
+                          size_t *segments, size_t *plaintext_len) {
+    if (segment_size == 0 || ciphertext_len < GFRX_TAG_SIZE) {
+        return GFRX_ERR_INVALID;
+    }
+
+    /* Every segment but the last is full; the last one holds at least its tag. */
+    size_t stride = segment_size + GFRX_TAG_SIZE;
+    size_t n = (ciphertext_len + stride - 1) / stride;
+    if (ciphertext_len - (n - 1) * stride < GFRX_TAG_SIZE || n > 0xFFFFFFFFu) {
+        return GFRX_ERR_INVALID;
+    }
+    *segments = n;
+    *plaintext_len = ciphertext_len - n * GFRX_TAG_SIZE;
+    return GFRX_SUCCESS;
+}
+
+int cofb_encrypt_segment(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                         uint64_t index, int last, const byte_t *plaintext, size_t plaintext_len,
+                         byte_t *out) {
+    byte_t seg_nonce[GFRX_NONCE_SIZE];
+    if (!out || cofb_segment_nonce(key, nonce, index, last, seg_nonce) != GFRX_SUCCESS) {
+        return GFRX_ERR_INVALID;
+    }
+    return cofb_encrypt_ctx(key, seg_nonce, ad, ad_len, plaintext, plaintext_len,
+                            out, out + plaintext_len);
+}
+
+int cofb_decrypt_segment(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                         uint64_t index, int last, const byte_t *in, size_t in_len,
+                         byte_t *plaintext) {
+    byte_t seg_nonce[GFRX_NONCE_SIZE];
+    if (!in || in_len < GFRX_TAG_SIZE ||
+        cofb_segment_nonce(key, nonce, index, last, seg_nonce) != GFRX_SUCCESS) {
+        return GFRX_ERR_INVALID;
+    }
+    size_t len = in_len - GFRX_TAG_SIZE;
+    return cofb_decrypt_ctx(key, seg_nonce, ad, ad_len, in, len, in + len, plaintext);
+}
+
+typedef struct {
+    const cofb_key_t *key;
+    const byte_t *nonce;
+    const byte_t *ad;
+    size_t ad_len;
+    const byte_t *in;
+    size_t plaintext_len;
+    size_t segment_size;
+    size_t segments;
+    uint64_t first;         /* message index of segment 0 of this job */
+    int final;              /* the job ends with the message's last segment */
+    byte_t *out;
+    int decrypt;
+    size_t next;
+    int failed;
+} seg_job_t;
+
+static int seg_process(seg_job_t *job, size_t i) {
+    int last = job->final && i + 1 == job->segments;
+    uint64_t index = job->first + i;
+    size_t pt_off = i * job->segment_size;
+    size_t ct_off = i * (job->segment_size + GFRX_TAG_SIZE);
+    size_t len = (i + 1 == job->segments) ? job->plaintext_len - pt_off : job->segment_size;
+
+    if (!job->decrypt) {
+        return cofb_encrypt_segment(job->key, job->nonce, job->ad, job->ad_len, index, last,
+                                    job->in + pt_off, len, job->out + ct_off);
+    }
+    return cofb_decrypt_segment(job->key, job->nonce, job->ad, job->ad_len, index, last,
+                                job->in + ct_off, len + GFRX_TAG_SIZE, job->out ? job->out + pt_off : NULL);
+}
+
+/* Workers claim segment indices from a shared counter until none remain. */
+static void *seg_worker(void *arg) {
+    seg_job_t *job = arg;
+    for (;;) {
+        size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (i >= job->segments) {
+            break;
+        }
+        if (seg_process(job, i) != GFRX_SUCCESS) {
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+static void seg_run(seg_job_t *job, unsigned nthreads) {
+    if (nthreads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (n > 0) ? (unsigned)n : 1;
+    }
+    if (nthreads > job->segments) {
+        nthreads = (unsigned)job->segments;
+    }
+
+    pthread_t threads[COFB_SEGMENT_MAX_THREADS];
+    unsigned started = 0;
+    if (nthreads > COFB_SEGMENT_MAX_THREADS) {
+        nthreads = COFB_SEGMENT_MAX_THREADS;
+    }
+
+    /* The calling thread is worker 0; fall back to fewer threads if creation fails. */
+    for (unsigned t = 1; t < nthreads; t++) {
+        if (pthread_create(&threads[started], NULL, seg_worker, job) != 0) {
+            break;
+        }
+        started++;
+    }
+    seg_worker(job);
+    for (unsigned t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+int cofb_encrypt_segments(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                          uint64_t first, int final, const byte_t *plaintext, size_t plaintext_len,
+                          size_t segment_size, byte_t *out, unsigned nthreads) {
+    size_t segments = cofb_segment_count(plaintext_len, segment_size);
+    if (!key || !nonce || !out || segments == 0 || segments > 0xFFFFFFFFu ||
+        first > 0xFFFFFFFFu - (segments - 1) ||
+        (plaintext_len > 0 && !plaintext) || (!final && plaintext_len % segment_size != 0)) {
+        return GFRX_ERR_INVALID;
+    }
+
+    seg_job_t job = { key, nonce, ad, ad_len, plaintext, plaintext_len, segment_size,
+                      segments, first, final, out, 0, 0, 0 };
+    seg_run(&job, nthreads);
+    return job.failed ? GFRX_ERR_INVALID : GFRX_SUCCESS;
+}
+
+int cofb_decrypt_segments(const cofb_key_t *key, const byte_t *nonce, const byte_t *ad, size_t ad_len,
+                          uint64_t first, int final, const byte_t *in, size_t in_len,
+                          size_t segment_size, byte_t *plaintext, unsigned nthreads) {
+    size_t segments, plaintext_len;
+    if (!key || !nonce || !in ||
+        cofb_segmented_layout(in_len, segment_size, &segments, &plaintext_len) != GFRX_SUCCESS) {
+        return GFRX_ERR_INVALID;
+    }
+    /* Only the final range may end in a short segment. */
+    if ((!final && plaintext_len != segments * segment_size) || first > 0xFFFFFFFFu - (segments - 1)) {
+        return GFRX_ERR_INVALID;
+    }
+
+    seg_job_t job = { key, nonce, ad, ad_len, in, plaintext_len, segment_size,
+                      segments, first, final, plaintext, 1, 0, 0 };
+    seg_run(&job, nthreads);
+
+    if (job.failed) {
+        if (plaintext && plaintext_len > 0) {
+            secure_zero(plaintext, plaintext_len);
+        }
+        return GFRX_ERR_AUTH;
+    }
+    return GFRX_SUCCESS;
+}
+
+int cofb_encrypt_segmented(const cofb_key_t *key, const byte_t *nonce,
+                           const byte_t *ad, size_t ad_len,
+                           const byte_t *plaintext, size_t plaintext_len,
+                           size_t segment_size, byte_t *ciphertext, unsigned nthreads) {
+    return cofb_encrypt_segments(key, nonce, ad, ad_len, 0, 1, plaintext, plaintext_len,
+                                 segment_size, ciphertext, nthreads);
+}
+
+int cofb_decrypt_segmented(const cofb_key_t *key, const byte_t *nonce,
+                           const byte_t *ad, size_t ad_len,
+                           const byte_t *ciphertext, size_t ciphertext_len,
+                           size_t segment_size, byte_t *plaintext, unsigned nthreads) {
+    return cofb_decrypt_segments(key, nonce, ad, ad_len, 0, 1, ciphertext, ciphertext_len,
+                                 segment_size, plaintext, nthreads);
+}
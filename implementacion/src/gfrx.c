@@ -1,24 +1,6 @@
-#include "../include/gfrx_cofb.h"
+#include "gfrx_internal.h"
 #include <stdio.h>
 
-#define ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
-#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
-
-static inline word32_t FAN(word32_t x0, word32_t x1, word32_t key) {
-    word32_t t1 = ROTL32(x1, 1);
-    word32_t t8 = ROTL32(x1, 8);
-    word32_t t2 = ROTL32(x1, 2);
-    return (t1 & t8) ^ x0 ^ t2 ^ key;
-}
-
-static inline word32_t FADL(word32_t x, word32_t y) {
-    return ROTL32((x + y) & 0xFFFFFFFF, 8);
-}
-
-static inline word32_t FADR(word32_t x, word32_t y) {
-    return ROTL32(x ^ y, 3);
-}
-
 static inline word32_t FADL_INV(word32_t x, word32_t y) {
     word32_t temp = ROTR32(x, 8);
     return (temp - y) & 0xFFFFFFFF;
@@ -58,21 +40,6 @@ static void gfrx_key_schedule(word32_t *round_keys, const byte_t *key) {
     }
 }
 
-static void gfrx_round_encrypt(word32_t *state, const word32_t *round_key) {
-    word32_t L0 = state[0], L1 = state[1];
-    word32_t R0 = state[2], R1 = state[3];
-
-    word32_t state0 = FAN(L0, L1, round_key[0]);
-    word32_t state1 = FADL(L1, R0) ^ round_key[1];
-    word32_t state2 = FADR(R0, state1);
-    word32_t state3 = FAN(R1, R0, round_key[2]);
-
-    state[0] = state1;
-    state[1] = state3;
-    state[2] = state0;
-    state[3] = state2;
-}
-
 static void gfrx_round_decrypt(word32_t *state, const word32_t *round_key) {
     word32_t state1 = state[0];
     word32_t state3 = state[1];
@@ -109,21 +76,9 @@ int gfrx_init(gfrx_ctx_t *ctx, const byte_t *key) {
 
 void gfrx_encrypt_block(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
     word32_t state[4];
-    for (int i = 0; i < 4; i++) {
-        state[i] = ((word32_t)plaintext[i*4 + 0]) |
-                   ((word32_t)plaintext[i*4 + 1] << 8) |
-                   ((word32_t)plaintext[i*4 + 2] << 16) |
-                   ((word32_t)plaintext[i*4 + 3] << 24);
-    }
-    for (int r = 0; r < GFRX_ROUNDS; r++) {
-        gfrx_round_encrypt(state, &ctx->round_keys[r * 4]);
-    }
-    for (int i = 0; i < 4; i++) {
-        ciphertext[i*4 + 0] = (state[i] >> 0) & 0xFF;
-        ciphertext[i*4 + 1] = (state[i] >> 8) & 0xFF;
-        ciphertext[i*4 + 2] = (state[i] >> 16) & 0xFF;
-        ciphertext[i*4 + 3] = (state[i] >> 24) & 0xFF;
-    }
+    load_block_le(state, plaintext);
+    gfrx_encrypt_words(ctx->round_keys, state);
+    store_block_le(ciphertext, state);
 }
 
 void gfrx_decrypt_block(const gfrx_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext) {
@@ -144,3 +99,109 @@ void gfrx_decrypt_block(const gfrx_ctx_t *ctx, const byte_t *ciphertext, byte_t
         plaintext[i*4 + 3] = (state[i] >> 24) & 0xFF;
     }
 }
+
+/*
+ * Interleaved multi-block encryption: every lane gets its own named state
+ * words so the compiler keeps them in registers, and each round is issued
+ * for all lanes back to back so the independent ARX chains overlap in the
+ * pipeline instead of serialising on one block's 32-round dependency.
+ */
+#define LANE_DECL(n) word32_t L0_##n, L1_##n, R0_##n, R1_##n
+
+#define LANE_LOAD(n) do {                                   \
+        const byte_t *p_ = plaintext + (n) * GFRX_BLOCK_SIZE; \
+        L0_##n = load32_le(p_ + 0);                         \
+        L1_##n = load32_le(p_ + 4);                         \
+        R0_##n = load32_le(p_ + 8);                         \
+        R1_##n = load32_le(p_ + 12);                        \
+    } while (0)
+
+#define LANE_ROUND(n) do {                                  \
+        const word32_t *k_ = &rk[n][r * 4];                 \
+        word32_t s0_ = FAN(L0_##n, L1_##n, k_[0]);          \
+        word32_t s1_ = FADL(L1_##n, R0_##n) ^ k_[1];        \
+        word32_t s2_ = FADR(R0_##n, s1_);                   \
+        word32_t s3_ = FAN(R1_##n, R0_##n, k_[2]);          \
+        L0_##n = s1_;                                       \
+        L1_##n = s3_;                                       \
+        R0_##n = s0_;                                       \
+        R1_##n = s2_;                                       \
+    } while (0)
+
+#define LANE_STORE(n) do {                                  \
+        byte_t *c_ = ciphertext + (n) * GFRX_BLOCK_SIZE;    \
+        store32_le(c_ + 0, L0_##n);                         \
+        store32_le(c_ + 4, L1_##n);                         \
+        store32_le(c_ + 8, R0_##n);                         \
+        store32_le(c_ + 12, R1_##n);                        \
+    } while (0)
+
+static void gfrx_encrypt_lanes2(const word32_t *const *rk, const byte_t *plaintext, byte_t *ciphertext) {
+    LANE_DECL(0); LANE_DECL(1);
+    LANE_LOAD(0); LANE_LOAD(1);
+    for (int r = 0; r < GFRX_ROUNDS; r++) {
+        LANE_ROUND(0); LANE_ROUND(1);
+    }
+    LANE_STORE(0); LANE_STORE(1);
+}
+
+static void gfrx_encrypt_lanes4(const word32_t *const *rk, const byte_t *plaintext, byte_t *ciphertext) {
+    LANE_DECL(0); LANE_DECL(1); LANE_DECL(2); LANE_DECL(3);
+    LANE_LOAD(0); LANE_LOAD(1); LANE_LOAD(2); LANE_LOAD(3);
+    for (int r = 0; r < GFRX_ROUNDS; r++) {
+        LANE_ROUND(0); LANE_ROUND(1); LANE_ROUND(2); LANE_ROUND(3);
+    }
+    LANE_STORE(0); LANE_STORE(1); LANE_STORE(2); LANE_STORE(3);
+}
+
+static void gfrx_encrypt_lanes8(const word32_t *const *rk, const byte_t *plaintext, byte_t *ciphertext) {
+    LANE_DECL(0); LANE_DECL(1); LANE_DECL(2); LANE_DECL(3);
+    LANE_DECL(4); LANE_DECL(5); LANE_DECL(6); LANE_DECL(7);
+    LANE_LOAD(0); LANE_LOAD(1); LANE_LOAD(2); LANE_LOAD(3);
+    LANE_LOAD(4); LANE_LOAD(5); LANE_LOAD(6); LANE_LOAD(7);
+    for (int r = 0; r < GFRX_ROUNDS; r++) {
+        LANE_ROUND(0); LANE_ROUND(1); LANE_ROUND(2); LANE_ROUND(3);
+        LANE_ROUND(4); LANE_ROUND(5); LANE_ROUND(6); LANE_ROUND(7);
+    }
+    LANE_STORE(0); LANE_STORE(1); LANE_STORE(2); LANE_STORE(3);
+    LANE_STORE(4); LANE_STORE(5); LANE_STORE(6); LANE_STORE(7);
+}
+
+void gfrx_encrypt_blocks_x2(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    const word32_t *rk[2] = { ctx->round_keys, ctx->round_keys };
+    gfrx_encrypt_lanes2(rk, plaintext, ciphertext);
+}
+
+void gfrx_encrypt_blocks_x4(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    const word32_t *rk[4] = { ctx->round_keys, ctx->round_keys, ctx->round_keys, ctx->round_keys };
+    gfrx_encrypt_lanes4(rk, plaintext, ciphertext);
+}
+
+void gfrx_encrypt_blocks_x8(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    const word32_t *rk[8];
+    for (int l = 0; l < 8; l++) {
+        rk[l] = ctx->round_keys;
+    }
+    gfrx_encrypt_lanes8(rk, plaintext, ciphertext);
+}
+
+void gfrx_encrypt_blocks_mk_x2(const gfrx_ctx_t *const ctx[2], const byte_t *plaintext, byte_t *ciphertext) {
+    const word32_t *rk[2] = { ctx[0]->round_keys, ctx[1]->round_keys };
+    gfrx_encrypt_lanes2(rk, plaintext, ciphertext);
+}
+
+void gfrx_encrypt_blocks_mk_x4(const gfrx_ctx_t *const ctx[4], const byte_t *plaintext, byte_t *ciphertext) {
+    const word32_t *rk[4];
+    for (int l = 0; l < 4; l++) {
+        rk[l] = ctx[l]->round_keys;
+    }
+    gfrx_encrypt_lanes4(rk, plaintext, ciphertext);
+}
+
+void gfrx_encrypt_blocks_mk_x8(const gfrx_ctx_t *const ctx[8], const byte_t *plaintext, byte_t *ciphertext) {
+    const word32_t *rk[8];
+    for (int l = 0; l < 8; l++) {
+        rk[l] = ctx[l]->round_keys;
+    }
+    gfrx_encrypt_lanes8(rk, plaintext, ciphertext);
+}
@@ -0,0 +1,152 @@
+#include "../include/gfrx_cofb.h"
+
+/*
+ * AVX2 8-way GFRX: the eight blocks are transposed so that vector word i
+ * holds word i of every block (word-sliced layout). Every FAN/FADL/FADR
+ * operation then becomes one 32-bit vector instruction over all lanes.
+ * This file is compiled with -mavx2 on x86; elsewhere it falls back to the
+ * scalar 8-lane kernel.
+ */
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+static inline __m256i rotl_1(__m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, 1), _mm256_srli_epi32(x, 31));
+}
+
+static inline __m256i rotl_2(__m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, 2), _mm256_srli_epi32(x, 30));
+}
+
+static inline __m256i rotl_3(__m256i x) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, 3), _mm256_srli_epi32(x, 29));
+}
+
+static inline __m256i rotl_8(__m256i x) {
+    const __m256i shuf = _mm256_setr_epi8(
+        3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+        3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    return _mm256_shuffle_epi8(x, shuf);
+}
+
+static inline __m256i FAN_x8(__m256i x0, __m256i x1, __m256i key) {
+    __m256i t = _mm256_and_si256(rotl_1(x1), rotl_8(x1));
+    return _mm256_xor_si256(_mm256_xor_si256(t, x0), _mm256_xor_si256(rotl_2(x1), key));
+}
+
+static inline __m256i FADL_x8(__m256i x, __m256i y) {
+    return rotl_8(_mm256_add_epi32(x, y));
+}
+
+static inline __m256i FADR_x8(__m256i x, __m256i y) {
+    return rotl_3(_mm256_xor_si256(x, y));
+}
+
+/* 4x4 transpose of 32-bit words inside each 128-bit half. */
+static inline void transpose_x8(__m256i *w0, __m256i *w1, __m256i *w2, __m256i *w3) {
+    __m256i t0 = _mm256_unpacklo_epi32(*w0, *w1);
+    __m256i t1 = _mm256_unpacklo_epi32(*w2, *w3);
+    __m256i t2 = _mm256_unpackhi_epi32(*w0, *w1);
+    __m256i t3 = _mm256_unpackhi_epi32(*w2, *w3);
+    *w0 = _mm256_unpacklo_epi64(t0, t1);
+    *w1 = _mm256_unpackhi_epi64(t0, t1);
+    *w2 = _mm256_unpacklo_epi64(t2, t3);
+    *w3 = _mm256_unpackhi_epi64(t2, t3);
+}
+
+static inline __m256i load_pair(const byte_t *lo, const byte_t *hi) {
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)lo)),
+        _mm_loadu_si128((const __m128i *)hi), 1);
+}
+
+static inline void store_pair(byte_t *lo, byte_t *hi, __m256i v) {
+    _mm_storeu_si128((__m128i *)lo, _mm256_castsi256_si128(v));
+    _mm_storeu_si128((__m128i *)hi, _mm256_extracti128_si256(v, 1));
+}
+
+/* Block b of the batch lives at offset b * 16; lanes are ordered 0..7. */
+static inline void load_sliced(const byte_t *in, __m256i *w) {
+    w[0] = load_pair(in + 0 * GFRX_BLOCK_SIZE, in + 4 * GFRX_BLOCK_SIZE);
+    w[1] = load_pair(in + 1 * GFRX_BLOCK_SIZE, in + 5 * GFRX_BLOCK_SIZE);
+    w[2] = load_pair(in + 2 * GFRX_BLOCK_SIZE, in + 6 * GFRX_BLOCK_SIZE);
+    w[3] = load_pair(in + 3 * GFRX_BLOCK_SIZE, in + 7 * GFRX_BLOCK_SIZE);
+    transpose_x8(&w[0], &w[1], &w[2], &w[3]);
+}
+
+static inline void store_sliced(byte_t *out, __m256i *w) {
+    transpose_x8(&w[0], &w[1], &w[2], &w[3]);
+    store_pair(out + 0 * GFRX_BLOCK_SIZE, out + 4 * GFRX_BLOCK_SIZE, w[0]);
+    store_pair(out + 1 * GFRX_BLOCK_SIZE, out + 5 * GFRX_BLOCK_SIZE, w[1]);
+    store_pair(out + 2 * GFRX_BLOCK_SIZE, out + 6 * GFRX_BLOCK_SIZE, w[2]);
+    store_pair(out + 3 * GFRX_BLOCK_SIZE, out + 7 * GFRX_BLOCK_SIZE, w[3]);
+}
+
+/*
+ * KEY(r, j) yields round r's key word j for all lanes: a broadcast for a
+ * shared key schedule, or a pre-sliced vector when every lane has its own.
+ */
+#define GFRX_ROUNDS_X8(w, KEY) do {                                         \
+        __m256i L0 = (w)[0], L1 = (w)[1], R0 = (w)[2], R1 = (w)[3];         \
+        for (int r = 0; r < GFRX_ROUNDS; r++) {                             \
+            __m256i state0 = FAN_x8(L0, L1, KEY(r, 0));                     \
+            __m256i state1 = _mm256_xor_si256(FADL_x8(L1, R0), KEY(r, 1));  \
+            __m256i state2 = FADR_x8(R0, state1);                           \
+            __m256i state3 = FAN_x8(R1, R0, KEY(r, 2));                     \
+            L0 = state1;                                                    \
+            L1 = state3;                                                    \
+            R0 = state0;                                                    \
+            R1 = state2;                                                    \
+        }                                                                   \
+        (w)[0] = L0; (w)[1] = L1; (w)[2] = R0; (w)[3] = R1;                 \
+    } while (0)
+
+#define KEY_BCAST(r, j)  _mm256_set1_epi32((int)ctx->round_keys[(r) * 4 + (j)])
+#define KEY_SLICED(r, j) rk[(r) * 4 + (j)]
+
+void gfrx_encrypt_blocks_avx2_x8(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    __m256i w[4];
+    load_sliced(plaintext, w);
+    GFRX_ROUNDS_X8(w, KEY_BCAST);
+    store_sliced(ciphertext, w);
+}
+
+void gfrx_encrypt_blocks_avx2_mk_x8(const gfrx_ctx_t *const ctx[8], const byte_t *plaintext, byte_t *ciphertext) {
+    /* Round r's four key words of each lane form a 16-byte row; slice them like blocks. */
+    __m256i rk[4 * GFRX_ROUNDS];
+    for (int r = 0; r < GFRX_ROUNDS; r++) {
+        __m256i *k = &rk[r * 4];
+        k[0] = load_pair((const byte_t *)&ctx[0]->round_keys[r * 4], (const byte_t *)&ctx[4]->round_keys[r * 4]);
+        k[1] = load_pair((const byte_t *)&ctx[1]->round_keys[r * 4], (const byte_t *)&ctx[5]->round_keys[r * 4]);
+        k[2] = load_pair((const byte_t *)&ctx[2]->round_keys[r * 4], (const byte_t *)&ctx[6]->round_keys[r * 4]);
+        k[3] = load_pair((const byte_t *)&ctx[3]->round_keys[r * 4], (const byte_t *)&ctx[7]->round_keys[r * 4]);
+        transpose_x8(&k[0], &k[1], &k[2], &k[3]);
+    }
+
+    __m256i w[4];
+    load_sliced(plaintext, w);
+    GFRX_ROUNDS_X8(w, KEY_SLICED);
+    store_sliced(ciphertext, w);
+}
+
+int gfrx_avx2_available(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+void gfrx_encrypt_blocks_avx2_x8(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    gfrx_encrypt_blocks_x8(ctx, plaintext, ciphertext);
+}
+
+void gfrx_encrypt_blocks_avx2_mk_x8(const gfrx_ctx_t *const ctx[8], const byte_t *plaintext, byte_t *ciphertext) {
+    gfrx_encrypt_blocks_mk_x8(ctx, plaintext, ciphertext);
+}
+
+int gfrx_avx2_available(void) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include "../include/gfrx_cofb.h"
+
+/*
+ * AVX-512 16-way GFRX, same word-sliced layout as the AVX2 kernel but with
+ * 16 lanes. ROTL32 is a single vprold, and FAN's
+ * (t1 & t8) ^ x0 ^ t2 ^ key collapses into two vpternlogd.
+ * This file is compiled with -mavx512f on x86; elsewhere it falls back to
+ * two scalar 8-lane calls.
+ */
+
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+/* vpternlogd truth tables over (a, b, c) = (0xF0, 0xCC, 0xAA) */
+#define TERN_AND_XOR  0x6A  /* (a & b) ^ c */
+#define TERN_XOR3     0x96  /* a ^ b ^ c   */
+
+static inline __m512i FAN_x16(__m512i x0, __m512i x1, __m512i key) {
+    __m512i t = _mm512_ternarylogic_epi32(_mm512_rol_epi32(x1, 1), _mm512_rol_epi32(x1, 8), x0, TERN_AND_XOR);
+    return _mm512_ternarylogic_epi32(t, _mm512_rol_epi32(x1, 2), key, TERN_XOR3);
+}
+
+static inline __m512i FADL_x16(__m512i x, __m512i y) {
+    return _mm512_rol_epi32(_mm512_add_epi32(x, y), 8);
+}
+
+static inline __m512i FADR_x16(__m512i x, __m512i y) {
+    return _mm512_rol_epi32(_mm512_xor_si512(x, y), 3);
+}
+
+/* 4x4 transpose of 32-bit words inside each 128-bit quarter. */
+static inline void transpose_x16(__m512i *w0, __m512i *w1, __m512i *w2, __m512i *w3) {
+    __m512i t0 = _mm512_unpacklo_epi32(*w0, *w1);
+    __m512i t1 = _mm512_unpacklo_epi32(*w2, *w3);
+    __m512i t2 = _mm512_unpackhi_epi32(*w0, *w1);
+    __m512i t3 = _mm512_unpackhi_epi32(*w2, *w3);
+    *w0 = _mm512_unpacklo_epi64(t0, t1);
+    *w1 = _mm512_unpackhi_epi64(t0, t1);
+    *w2 = _mm512_unpacklo_epi64(t2, t3);
+    *w3 = _mm512_unpackhi_epi64(t2, t3);
+}
+
+/* Rows p, p + 4*stride, p + 8*stride and p + 12*stride into one register. */
+static inline __m512i load_quad(const byte_t *p, size_t stride) {
+    __m512i v = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i *)p));
+    v = _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *)(p + 4 * stride)), 1);
+    v = _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *)(p + 8 * stride)), 2);
+    v = _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *)(p + 12 * stride)), 3);
+    return v;
+}
+
+static inline void store_quad(byte_t *p, __m512i v) {
+    _mm_storeu_si128((__m128i *)(p + 0 * GFRX_BLOCK_SIZE), _mm512_extracti32x4_epi32(v, 0));
+    _mm_storeu_si128((__m128i *)(p + 4 * GFRX_BLOCK_SIZE), _mm512_extracti32x4_epi32(v, 1));
+    _mm_storeu_si128((__m128i *)(p + 8 * GFRX_BLOCK_SIZE), _mm512_extracti32x4_epi32(v, 2));
+    _mm_storeu_si128((__m128i *)(p + 12 * GFRX_BLOCK_SIZE), _mm512_extracti32x4_epi32(v, 3));
+}
+
+static inline void load_sliced(const byte_t *in, __m512i *w) {
+    for (int i = 0; i < 4; i++) {
+        w[i] = load_quad(in + i * GFRX_BLOCK_SIZE, GFRX_BLOCK_SIZE);
+    }
+    transpose_x16(&w[0], &w[1], &w[2], &w[3]);
+}
+
+static inline void store_sliced(byte_t *out, __m512i *w) {
+    transpose_x16(&w[0], &w[1], &w[2], &w[3]);
+    for (int i = 0; i < 4; i++) {
+        store_quad(out + i * GFRX_BLOCK_SIZE, w[i]);
+    }
+}
+
+#define GFRX_ROUNDS_X16(w, KEY) do {                                        \
+        __m512i L0 = (w)[0], L1 = (w)[1], R0 = (w)[2], R1 = (w)[3];         \
+        for (int r = 0; r < GFRX_ROUNDS; r++) {                             \
+            __m512i state0 = FAN_x16(L0, L1, KEY(r, 0));                    \
+            __m512i state1 = _mm512_xor_si512(FADL_x16(L1, R0), KEY(r, 1)); \
+            __m512i state2 = FADR_x16(R0, state1);                          \
+            __m512i state3 = FAN_x16(R1, R0, KEY(r, 2));                    \
+            L0 = state1;                                                    \
+            L1 = state3;                                                    \
+            R0 = state0;                                                    \
+            R1 = state2;                                                    \
+        }                                                                   \
+        (w)[0] = L0; (w)[1] = L1; (w)[2] = R0; (w)[3] = R1;                 \
+    } while (0)
+
+#define KEY_BCAST(r, j)  _mm512_set1_epi32((int)ctx->round_keys[(r) * 4 + (j)])
+#define KEY_SLICED(r, j) rk[(r) * 4 + (j)]
+
+void gfrx_encrypt_blocks_avx512_x16(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    __m512i w[4];
+    load_sliced(plaintext, w);
+    GFRX_ROUNDS_X16(w, KEY_BCAST);
+    store_sliced(ciphertext, w);
+}
+
+void gfrx_encrypt_blocks_avx512_mk_x16(const gfrx_ctx_t *const ctx[16], const byte_t *plaintext, byte_t *ciphertext) {
+    __m512i rk[4 * GFRX_ROUNDS];
+    for (int r = 0; r < GFRX_ROUNDS; r++) {
+        __m512i *k = &rk[r * 4];
+        for (int i = 0; i < 4; i++) {
+            __m512i v = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i *)&ctx[i]->round_keys[r * 4]));
+            v = _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *)&ctx[i + 4]->round_keys[r * 4]), 1);
+            v = _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *)&ctx[i + 8]->round_keys[r * 4]), 2);
+            v = _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *)&ctx[i + 12]->round_keys[r * 4]), 3);
+            k[i] = v;
+        }
+        transpose_x16(&k[0], &k[1], &k[2], &k[3]);
+    }
+
+    __m512i w[4];
+    load_sliced(plaintext, w);
+    GFRX_ROUNDS_X16(w, KEY_SLICED);
+    store_sliced(ciphertext, w);
+}
+
+int gfrx_avx512_available(void) {
+    return __builtin_cpu_supports("avx512f");
+}
+
+#else
+
+void gfrx_encrypt_blocks_avx512_x16(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    gfrx_encrypt_blocks_x8(ctx, plaintext, ciphertext);
+    gfrx_encrypt_blocks_x8(ctx, plaintext + 8 * GFRX_BLOCK_SIZE, ciphertext + 8 * GFRX_BLOCK_SIZE);
+}
+
+void gfrx_encrypt_blocks_avx512_mk_x16(const gfrx_ctx_t *const ctx[16], const byte_t *plaintext, byte_t *ciphertext) {
+    gfrx_encrypt_blocks_mk_x8(ctx, plaintext, ciphertext);
+    gfrx_encrypt_blocks_mk_x8(ctx + 8, plaintext + 8 * GFRX_BLOCK_SIZE, ciphertext + 8 * GFRX_BLOCK_SIZE);
+}
+
+int gfrx_avx512_available(void) {
+    return 0;
+}
+
+#endif
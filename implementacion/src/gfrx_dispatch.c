@@ -0,0 +1,141 @@
+#include "../include/gfrx_cofb.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Runtime selection of the multi-block GFRX kernel. The widest backend the
+ * CPU supports is chosen on first use (CPUID via __builtin_cpu_supports in
+ * each backend's *_available()); GFRX_BACKEND=scalar|sse2|avx2|avx512 in the
+ * environment forces one, provided the CPU can run it.
+ */
+
+typedef struct {
+    const char *name;
+    size_t lanes;
+    void (*encrypt_lanes)(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+    void (*encrypt_lanes_mk)(const gfrx_ctx_t *const *ctx, const byte_t *plaintext, byte_t *ciphertext);
+    int (*available)(void);
+} gfrx_backend_t;
+
+static int scalar_available(void) {
+    return 1;
+}
+
+/* Ordered from most to least preferred. */
+static const gfrx_backend_t BACKENDS[] = {
+    { "avx512", 16, gfrx_encrypt_blocks_avx512_x16, gfrx_encrypt_blocks_avx512_mk_x16, gfrx_avx512_available },
+    { "avx2",   8,  gfrx_encrypt_blocks_avx2_x8,    gfrx_encrypt_blocks_avx2_mk_x8,    gfrx_avx2_available },
+    { "sse2",   4,  gfrx_encrypt_blocks_sse2_x4,    gfrx_encrypt_blocks_sse2_mk_x4,    gfrx_sse2_available },
+    { "scalar", 4,  gfrx_encrypt_blocks_x4,         gfrx_encrypt_blocks_mk_x4,         scalar_available },
+};
+
+#define NUM_BACKENDS (sizeof(BACKENDS) / sizeof(BACKENDS[0]))
+
+static const gfrx_backend_t *active_backend = NULL;
+
+static const gfrx_backend_t *find_backend(const char *name) {
+    for (size_t i = 0; i < NUM_BACKENDS; i++) {
+        if (strcmp(BACKENDS[i].name, name) == 0 && BACKENDS[i].available()) {
+            return &BACKENDS[i];
+        }
+    }
+    return NULL;
+}
+
+static const gfrx_backend_t *auto_backend(void) {
+    for (size_t i = 0; i < NUM_BACKENDS; i++) {
+        if (BACKENDS[i].available()) {
+            return &BACKENDS[i];
+        }
+    }
+    return &BACKENDS[NUM_BACKENDS - 1];
+}
+
+/* A GFRX_BACKEND that cannot be honoured is reported once, not silently replaced. */
+static int env_warned = 0;
+
+static const gfrx_backend_t *select_backend(void) {
+    const char *forced = getenv("GFRX_BACKEND");
+    if (forced != NULL) {
+        const gfrx_backend_t *b = find_backend(forced);
+        if (b != NULL) {
+            return b;
+        }
+        b = auto_backend();
+        if (!__atomic_exchange_n(&env_warned, 1, __ATOMIC_RELAXED)) {
+            fprintf(stderr, "Warning: GFRX_BACKEND=%s is unknown or not supported by this CPU; using %s\n",
+                    forced, b->name);
+        }
+        return b;
+    }
+    return auto_backend();
+}
+
+/* Selection is idempotent, so concurrent first calls may both run it safely. */
+static const gfrx_backend_t *backend(void) {
+    const gfrx_backend_t *b = __atomic_load_n(&active_backend, __ATOMIC_ACQUIRE);
+    if (b == NULL) {
+        b = select_backend();
+        __atomic_store_n(&active_backend, b, __ATOMIC_RELEASE);
+    }
+    return b;
+}
+
+const char *gfrx_backend_name(void) {
+    return backend()->name;
+}
+
+int gfrx_set_backend(const char *name) {
+    const gfrx_backend_t *b = (name != NULL) ? find_backend(name) : select_backend();
+    if (b == NULL) {
+        return GFRX_ERR_INVALID;
+    }
+    __atomic_store_n(&active_backend, b, __ATOMIC_RELEASE);
+    return GFRX_SUCCESS;
+}
+
+size_t gfrx_backend_lanes(void) {
+    return backend()->lanes;
+}
+
+void gfrx_encrypt_blocks(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext, size_t nblocks) {
+    const gfrx_backend_t *b = backend();
+
+    while (nblocks >= b->lanes) {
+        b->encrypt_lanes(ctx, plaintext, ciphertext);
+        plaintext += b->lanes * GFRX_BLOCK_SIZE;
+        ciphertext += b->lanes * GFRX_BLOCK_SIZE;
+        nblocks -= b->lanes;
+    }
+    while (nblocks >= 2) {
+        gfrx_encrypt_blocks_x2(ctx, plaintext, ciphertext);
+        plaintext += 2 * GFRX_BLOCK_SIZE;
+        ciphertext += 2 * GFRX_BLOCK_SIZE;
+        nblocks -= 2;
+    }
+    if (nblocks > 0) {
+        gfrx_encrypt_block(ctx, plaintext, ciphertext);
+    }
+}
+
+void gfrx_encrypt_blocks_mk(const gfrx_ctx_t *const *ctx, const byte_t *plaintext, byte_t *ciphertext, size_t nblocks) {
+    const gfrx_backend_t *b = backend();
+
+    while (nblocks >= b->lanes) {
+        b->encrypt_lanes_mk(ctx, plaintext, ciphertext);
+        ctx += b->lanes;
+        plaintext += b->lanes * GFRX_BLOCK_SIZE;
+        ciphertext += b->lanes * GFRX_BLOCK_SIZE;
+        nblocks -= b->lanes;
+    }
+    while (nblocks >= 2) {
+        gfrx_encrypt_blocks_mk_x2(ctx, plaintext, ciphertext);
+        ctx += 2;
+        plaintext += 2 * GFRX_BLOCK_SIZE;
+        ciphertext += 2 * GFRX_BLOCK_SIZE;
+        nblocks -= 2;
+    }
+    if (nblocks > 0) {
+        gfrx_encrypt_block(ctx[0], plaintext, ciphertext);
+    }
+}
@@ -0,0 +1,381 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/gfrx_engine.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * A task is a range of segments of one job (a plain job is the single
+ * range [0, 1)). Deques are small mutex-protected rings: the owner pushes
+ * and pops at the bottom, thieves take from the top, so stolen work is the
+ * oldest and, for split ranges, the largest.
+ */
+
+typedef struct {
+    gfrx_job_t *job;
+    size_t lo;
+    size_t hi;
+} task_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    task_t *tasks;
+    size_t cap;
+    size_t top;
+    size_t count;
+    pthread_t thread;
+    struct gfrx_engine *engine;
+    unsigned id;
+} worker_t;
+
+struct gfrx_engine {
+    unsigned nworkers;
+    worker_t *workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+
+    size_t queued;              /* tasks sitting in deques (atomic) */
+    unsigned sleeping;          /* workers waiting on work_cv (atomic) */
+    unsigned next_worker;       /* round-robin target for submissions (atomic) */
+    int stop;
+
+    size_t inflight;            /* submitted jobs not yet completed, under lock */
+    gfrx_job_t *done_head;
+    gfrx_job_t *done_tail;
+};
+
+#define DEQUE_INITIAL_CAP 64
+
+static int deque_push(worker_t *w, task_t t) {
+    pthread_mutex_lock(&w->lock);
+    if (w->count == w->cap) {
+        size_t cap = w->cap * 2;
+        task_t *tasks = malloc(cap * sizeof(*tasks));
+        if (tasks == NULL) {
+            pthread_mutex_unlock(&w->lock);
+            return GFRX_ERR_MEMORY;
+        }
+        for (size_t i = 0; i < w->count; i++) {
+            tasks[i] = w->tasks[(w->top + i) % w->cap];
+        }
+        free(w->tasks);
+        w->tasks = tasks;
+        w->cap = cap;
+        w->top = 0;
+    }
+    w->tasks[(w->top + w->count) % w->cap] = t;
+    w->count++;
+    pthread_mutex_unlock(&w->lock);
+    return GFRX_SUCCESS;
+}
+
+static int deque_pop(worker_t *w, task_t *t) {
+    int found = 0;
+    pthread_mutex_lock(&w->lock);
+    if (w->count > 0) {
+        w->count--;
+        *t = w->tasks[(w->top + w->count) % w->cap];
+        found = 1;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return found;
+}
+
+static int deque_steal(worker_t *w, task_t *t) {
+    int found = 0;
+    pthread_mutex_lock(&w->lock);
+    if (w->count > 0) {
+        *t = w->tasks[w->top];
+        w->top = (w->top + 1) % w->cap;
+        w->count--;
+        found = 1;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return found;
+}
+
+/* queued is raised before the push so a worker never sleeps while a task is on its way. */
+static int engine_push(gfrx_engine_t *e, worker_t *w, task_t t) {
+    __atomic_add_fetch(&e->queued, 1, __ATOMIC_SEQ_CST);
+    if (deque_push(w, t) != GFRX_SUCCESS) {
+        __atomic_sub_fetch(&e->queued, 1, __ATOMIC_SEQ_CST);
+        return GFRX_ERR_MEMORY;
+    }
+    if (__atomic_load_n(&e->sleeping, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&e->lock);
+        pthread_cond_signal(&e->work_cv);
+        pthread_mutex_unlock(&e->lock);
+    }
+    return GFRX_SUCCESS;
+}
+
+static int engine_take(gfrx_engine_t *e, worker_t *self, task_t *t) {
+    if (deque_pop(self, t)) {
+        __atomic_sub_fetch(&e->queued, 1, __ATOMIC_SEQ_CST);
+        return 1;
+    }
+    for (unsigned i = 1; i < e->nworkers; i++) {
+        worker_t *victim = &e->workers[(self->id + i) % e->nworkers];
+        if (deque_steal(victim, t)) {
+            __atomic_sub_fetch(&e->queued, 1, __ATOMIC_SEQ_CST);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void job_complete(gfrx_engine_t *e, gfrx_job_t *job) {
+    if (job->failed) {
+        job->result = (job->op == GFRX_JOB_DECRYPT) ? GFRX_ERR_AUTH : GFRX_ERR_INVALID;
+        if (job->op == GFRX_JOB_DECRYPT && job->segment_size > 0 && job->plaintext_len > 0) {
+            secure_zero(job->out, job->plaintext_len);
+        }
+    } else {
+        job->result = GFRX_SUCCESS;
+    }
+
+    /* The callback runs before inflight drops, so drain() also waits for it. */
+    void (*done)(gfrx_job_t *) = job->done;
+    if (done != NULL) {
+        done(job);
+    }
+
+    pthread_mutex_lock(&e->lock);
+    if (done == NULL) {
+        job->next = NULL;
+        if (e->done_tail != NULL) {
+            e->done_tail->next = job;
+        } else {
+            e->done_head = job;
+        }
+        e->done_tail = job;
+    }
+    e->inflight--;
+    pthread_cond_broadcast(&e->done_cv);
+    pthread_mutex_unlock(&e->lock);
+}
+
+static int run_segment(const gfrx_job_t *job, size_t i) {
+    int last = (i + 1 == job->segments);
+    size_t pt_off = i * job->segment_size;
+    size_t ct_off = i * (job->segment_size + GFRX_TAG_SIZE);
+    size_t len = last ? job->plaintext_len - pt_off : job->segment_size;
+
+    if (job->op == GFRX_JOB_ENCRYPT) {
+        return cofb_encrypt_segment(job->key, job->nonce, job->ad, job->ad_len, i, last,
+                                    job->in + pt_off, len, job->out + ct_off);
+    }
+    return cofb_decrypt_segment(job->key, job->nonce, job->ad, job->ad_len, i, last,
+                                job->in + ct_off, len + GFRX_TAG_SIZE, job->out + pt_off);
+}
+
+static void run_task(gfrx_engine_t *e, worker_t *self, task_t t) {
+    gfrx_job_t *job = t.job;
+    int ret;
+
+    if (job->segment_size == 0) {
+        if (job->op == GFRX_JOB_ENCRYPT) {
+            ret = cofb_encrypt_ctx(job->key, job->nonce, job->ad, job->ad_len,
+                                   job->in, job->in_len, job->out, job->tag);
+        } else {
+            ret = cofb_decrypt_ctx(job->key, job->nonce, job->ad, job->ad_len,
+                                   job->in, job->in_len, job->tag, job->out);
+        }
+    } else {
+        /* Keep one segment, leave the rest as halves for thieves (or for us, later). */
+        while (t.hi - t.lo > 1) {
+            size_t mid = t.lo + (t.hi - t.lo) / 2;
+            if (engine_push(e, self, (task_t){ job, mid, t.hi }) != GFRX_SUCCESS) {
+                break;
+            }
+            t.hi = mid;
+        }
+        ret = GFRX_SUCCESS;
+        for (size_t i = t.lo; i < t.hi; i++) {
+            if (run_segment(job, i) != GFRX_SUCCESS) {
+                ret = GFRX_ERR_AUTH;
+            }
+        }
+    }
+
+    if (ret != GFRX_SUCCESS) {
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+    }
+    if (__atomic_sub_fetch(&job->pending, t.hi - t.lo, __ATOMIC_ACQ_REL) == 0) {
+        job_complete(e, job);
+    }
+}
+
+static void *worker_main(void *arg) {
+    worker_t *self = arg;
+    gfrx_engine_t *e = self->engine;
+    task_t t;
+
+    for (;;) {
+        if (engine_take(e, self, &t)) {
+            run_task(e, self, t);
+            continue;
+        }
+
+        pthread_mutex_lock(&e->lock);
+        __atomic_add_fetch(&e->sleeping, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&e->queued, __ATOMIC_SEQ_CST) == 0 && !e->stop) {
+            pthread_cond_wait(&e->work_cv, &e->lock);
+        }
+        __atomic_sub_fetch(&e->sleeping, 1, __ATOMIC_SEQ_CST);
+        int stop = e->stop && __atomic_load_n(&e->queued, __ATOMIC_SEQ_CST) == 0;
+        pthread_mutex_unlock(&e->lock);
+        if (stop) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void engine_free(gfrx_engine_t *e, unsigned started) {
+    pthread_mutex_lock(&e->lock);
+    e->stop = 1;
+    pthread_cond_broadcast(&e->work_cv);
+    pthread_mutex_unlock(&e->lock);
+
+    for (unsigned i = 0; i < started; i++) {
+        pthread_join(e->workers[i].thread, NULL);
+    }
+    for (unsigned i = 0; i < e->nworkers; i++) {
+        pthread_mutex_destroy(&e->workers[i].lock);
+        free(e->workers[i].tasks);
+    }
+    pthread_cond_destroy(&e->done_cv);
+    pthread_cond_destroy(&e->work_cv);
+    pthread_mutex_destroy(&e->lock);
+    free(e->workers);
+    free(e);
+}
+
+gfrx_engine_t *gfrx_engine_create(unsigned nthreads) {
+    if (nthreads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (n > 0) ? (unsigned)n : 1;
+    }
+
+    gfrx_engine_t *e = calloc(1, sizeof(*e));
+    if (e == NULL) {
+        return NULL;
+    }
+    e->workers = calloc(nthreads, sizeof(*e->workers));
+    if (e->workers == NULL) {
+        free(e);
+        return NULL;
+    }
+    e->nworkers = nthreads;
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->work_cv, NULL);
+    pthread_cond_init(&e->done_cv, NULL);
+
+    int ok = 1;
+    for (unsigned i = 0; i < nthreads; i++) {
+        worker_t *w = &e->workers[i];
+        pthread_mutex_init(&w->lock, NULL);
+        w->cap = DEQUE_INITIAL_CAP;
+        w->tasks = malloc(w->cap * sizeof(*w->tasks));
+        w->engine = e;
+        w->id = i;
+        ok = ok && (w->tasks != NULL);
+    }
+    if (!ok) {
+        engine_free(e, 0);
+        return NULL;
+    }
+    for (unsigned i = 0; i < nthreads; i++) {
+        if (pthread_create(&e->workers[i].thread, NULL, worker_main, &e->workers[i]) != 0) {
+            engine_free(e, i);
+            return NULL;
+        }
+    }
+    return e;
+}
+
+unsigned gfrx_engine_threads(const gfrx_engine_t *engine) {
+    return engine->nworkers;
+}
+
+int gfrx_engine_submit(gfrx_engine_t *e, gfrx_job_t *job) {
+    if (!e || !job || !job->key || !job->nonce ||
+        (job->op != GFRX_JOB_ENCRYPT && job->op != GFRX_JOB_DECRYPT)) {
+        return GFRX_ERR_INVALID;
+    }
+
+    if (job->segment_size == 0) {
+        if (!job->tag || (job->op == GFRX_JOB_ENCRYPT && job->in_len > 0 && job->in && !job->out)) {
+            return GFRX_ERR_INVALID;
+        }
+        job->segments = 1;
+        job->plaintext_len = job->in_len;
+    } else if (job->op == GFRX_JOB_ENCRYPT) {
+        job->segments = cofb_segment_count(job->in_len, job->segment_size);
+        job->plaintext_len = job->in_len;
+        if (job->segments > 0xFFFFFFFFu || !job->out || (job->in_len > 0 && !job->in)) {
+            return GFRX_ERR_INVALID;
+        }
+    } else {
+        if (!job->in || cofb_segmented_layout(job->in_len, job->segment_size,
+                                              &job->segments, &job->plaintext_len) != GFRX_SUCCESS ||
+            (job->plaintext_len > 0 && !job->out)) {
+            return GFRX_ERR_INVALID;
+        }
+    }
+
+    job->pending = job->segments;
+    job->failed = 0;
+    job->result = GFRX_SUCCESS;
+    job->next = NULL;
+
+    pthread_mutex_lock(&e->lock);
+    e->inflight++;
+    pthread_mutex_unlock(&e->lock);
+
+    unsigned target = __atomic_fetch_add(&e->next_worker, 1, __ATOMIC_RELAXED) % e->nworkers;
+    if (engine_push(e, &e->workers[target], (task_t){ job, 0, job->segments }) != GFRX_SUCCESS) {
+        pthread_mutex_lock(&e->lock);
+        e->inflight--;
+        pthread_cond_broadcast(&e->done_cv);
+        pthread_mutex_unlock(&e->lock);
+        return GFRX_ERR_MEMORY;
+    }
+    return GFRX_SUCCESS;
+}
+
+gfrx_job_t *gfrx_engine_wait(gfrx_engine_t *e) {
+    pthread_mutex_lock(&e->lock);
+    while (e->done_head == NULL && e->inflight > 0) {
+        pthread_cond_wait(&e->done_cv, &e->lock);
+    }
+    gfrx_job_t *job = e->done_head;
+    if (job != NULL) {
+        e->done_head = job->next;
+        if (e->done_head == NULL) {
+            e->done_tail = NULL;
+        }
+    }
+    pthread_mutex_unlock(&e->lock);
+    return job;
+}
+
+void gfrx_engine_drain(gfrx_engine_t *e) {
+    pthread_mutex_lock(&e->lock);
+    while (e->inflight > 0) {
+        pthread_cond_wait(&e->done_cv, &e->lock);
+    }
+    pthread_mutex_unlock(&e->lock);
+}
+
+void gfrx_engine_destroy(gfrx_engine_t *e) {
+    if (e == NULL) {
+        return;
+    }
+    gfrx_engine_drain(e);
+    engine_free(e, e->nworkers);
+}
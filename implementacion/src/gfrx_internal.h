@@ -0,0 +1,51 @@
+#ifndef GFRX_INTERNAL_H
+#define GFRX_INTERNAL_H
+
+/*
+ * GFRX primitives shared by the library sources (not installed). Keeping
+ * them inline lets the COFB glue run the cipher directly on words.
+ */
+
+#include "../include/gfrx_cofb.h"
+#include "cofb_core.h"
+
+#define ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static inline word32_t FAN(word32_t x0, word32_t x1, word32_t key) {
+    word32_t t1 = ROTL32(x1, 1);
+    word32_t t8 = ROTL32(x1, 8);
+    word32_t t2 = ROTL32(x1, 2);
+    return (t1 & t8) ^ x0 ^ t2 ^ key;
+}
+
+static inline word32_t FADL(word32_t x, word32_t y) {
+    return ROTL32((x + y) & 0xFFFFFFFF, 8);
+}
+
+static inline word32_t FADR(word32_t x, word32_t y) {
+    return ROTL32(x ^ y, 3);
+}
+
+/* Full 32-round encryption of a block held as four little-endian words. */
+static inline void gfrx_encrypt_words(const word32_t *round_keys, word32_t *state) {
+    word32_t L0 = state[0], L1 = state[1];
+    word32_t R0 = state[2], R1 = state[3];
+
+    for (int r = 0; r < GFRX_ROUNDS; r++) {
+        const word32_t *k = &round_keys[r * 4];
+        word32_t state0 = FAN(L0, L1, k[0]);
+        word32_t state1 = FADL(L1, R0) ^ k[1];
+        word32_t state2 = FADR(R0, state1);
+        word32_t state3 = FAN(R1, R0, k[2]);
+
+        L0 = state1;
+        L1 = state3;
+        R0 = state0;
+        R1 = state2;
+    }
+
+    state[0] = L0; state[1] = L1; state[2] = R0; state[3] = R1;
+}
+
+#endif // GFRX_INTERNAL_H
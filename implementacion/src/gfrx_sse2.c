@@ -0,0 +1,114 @@
+#include "../include/gfrx_cofb.h"
+
+/*
+ * SSE2 4-way GFRX in the word-sliced layout of the AVX2 kernel, for x86
+ * CPUs without AVX2. SSE2 has no byte shuffle, so every rotate is a shift
+ * pair. Elsewhere it falls back to the scalar 4-lane kernel.
+ */
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define ROTL_X4(x, n) _mm_or_si128(_mm_slli_epi32((x), (n)), _mm_srli_epi32((x), 32 - (n)))
+
+static inline __m128i FAN_x4(__m128i x0, __m128i x1, __m128i key) {
+    __m128i t = _mm_and_si128(ROTL_X4(x1, 1), ROTL_X4(x1, 8));
+    return _mm_xor_si128(_mm_xor_si128(t, x0), _mm_xor_si128(ROTL_X4(x1, 2), key));
+}
+
+static inline __m128i FADL_x4(__m128i x, __m128i y) {
+    __m128i s = _mm_add_epi32(x, y);
+    return ROTL_X4(s, 8);
+}
+
+static inline __m128i FADR_x4(__m128i x, __m128i y) {
+    __m128i s = _mm_xor_si128(x, y);
+    return ROTL_X4(s, 3);
+}
+
+static inline void transpose_x4(__m128i *w0, __m128i *w1, __m128i *w2, __m128i *w3) {
+    __m128i t0 = _mm_unpacklo_epi32(*w0, *w1);
+    __m128i t1 = _mm_unpacklo_epi32(*w2, *w3);
+    __m128i t2 = _mm_unpackhi_epi32(*w0, *w1);
+    __m128i t3 = _mm_unpackhi_epi32(*w2, *w3);
+    *w0 = _mm_unpacklo_epi64(t0, t1);
+    *w1 = _mm_unpackhi_epi64(t0, t1);
+    *w2 = _mm_unpacklo_epi64(t2, t3);
+    *w3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+static inline void load_sliced(const byte_t *in, __m128i *w) {
+    for (int i = 0; i < 4; i++) {
+        w[i] = _mm_loadu_si128((const __m128i *)(in + i * GFRX_BLOCK_SIZE));
+    }
+    transpose_x4(&w[0], &w[1], &w[2], &w[3]);
+}
+
+static inline void store_sliced(byte_t *out, __m128i *w) {
+    transpose_x4(&w[0], &w[1], &w[2], &w[3]);
+    for (int i = 0; i < 4; i++) {
+        _mm_storeu_si128((__m128i *)(out + i * GFRX_BLOCK_SIZE), w[i]);
+    }
+}
+
+#define GFRX_ROUNDS_X4(w, KEY) do {                                         \
+        __m128i L0 = (w)[0], L1 = (w)[1], R0 = (w)[2], R1 = (w)[3];         \
+        for (int r = 0; r < GFRX_ROUNDS; r++) {                             \
+            __m128i state0 = FAN_x4(L0, L1, KEY(r, 0));                     \
+            __m128i state1 = _mm_xor_si128(FADL_x4(L1, R0), KEY(r, 1));     \
+            __m128i state2 = FADR_x4(R0, state1);                           \
+            __m128i state3 = FAN_x4(R1, R0, KEY(r, 2));                     \
+            L0 = state1;                                                    \
+            L1 = state3;                                                    \
+            R0 = state0;                                                    \
+            R1 = state2;                                                    \
+        }                                                                   \
+        (w)[0] = L0; (w)[1] = L1; (w)[2] = R0; (w)[3] = R1;                 \
+    } while (0)
+
+#define KEY_BCAST(r, j)  _mm_set1_epi32((int)ctx->round_keys[(r) * 4 + (j)])
+#define KEY_SLICED(r, j) rk[(r) * 4 + (j)]
+
+void gfrx_encrypt_blocks_sse2_x4(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    __m128i w[4];
+    load_sliced(plaintext, w);
+    GFRX_ROUNDS_X4(w, KEY_BCAST);
+    store_sliced(ciphertext, w);
+}
+
+void gfrx_encrypt_blocks_sse2_mk_x4(const gfrx_ctx_t *const ctx[4], const byte_t *plaintext, byte_t *ciphertext) {
+    __m128i rk[4 * GFRX_ROUNDS];
+    for (int r = 0; r < GFRX_ROUNDS; r++) {
+        __m128i *k = &rk[r * 4];
+        for (int i = 0; i < 4; i++) {
+            k[i] = _mm_loadu_si128((const __m128i *)&ctx[i]->round_keys[r * 4]);
+        }
+        transpose_x4(&k[0], &k[1], &k[2], &k[3]);
+    }
+
+    __m128i w[4];
+    load_sliced(plaintext, w);
+    GFRX_ROUNDS_X4(w, KEY_SLICED);
+    store_sliced(ciphertext, w);
+}
+
+int gfrx_sse2_available(void) {
+    return __builtin_cpu_supports("sse2");
+}
+
+#else
+
+void gfrx_encrypt_blocks_sse2_x4(const gfrx_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    gfrx_encrypt_blocks_x4(ctx, plaintext, ciphertext);
+}
+
+void gfrx_encrypt_blocks_sse2_mk_x4(const gfrx_ctx_t *const ctx[4], const byte_t *plaintext, byte_t *ciphertext) {
+    gfrx_encrypt_blocks_mk_x4(ctx, plaintext, ciphertext);
+}
+
+int gfrx_sse2_available(void) {
+    return 0;
+}
+
+#endif
@@ -5,6 +5,7 @@
  */
 
 #include "gift_cofb.h"
+#include <stdlib.h>
 
 /* GIFT-128 S-box (4-bit) */
 static const uint8_t GIFT_SBOX[16] = {
@@ -188,6 +189,7 @@ int gift_init(gift_ctx_t *ctx, const byte_t *key) {
 
     memset(ctx, 0, sizeof(gift_ctx_t));
     gift_key_schedule(ctx, key);
+    gift_fixsliced_key_schedule(ctx);
 
     return GIFT_SUCCESS;
 }
@@ -212,23 +214,26 @@ static void store_block(byte_t *block, const word32_t *state) {
     }
 }
 
-/* GIFT-128 encryption */
-void gift_encrypt_block(const gift_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
-    word32_t state[4];
-
-    load_block(state, plaintext);
-
+/* GIFT-128 encryption of a state already loaded as words */
+void gift_encrypt_words_reference(const gift_ctx_t *ctx, word32_t *state) {
     for (int round = 0; round < GIFT_ROUNDS; round++) {
         gift_subcells(state);
         gift_permbits(state);
         gift_addroundkey(state, &ctx->round_keys[2 * round], GIFT_RC[round]);
     }
+}
+
+/* GIFT-128 encryption */
+void gift_encrypt_block_reference(const gift_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    word32_t state[4];
 
+    load_block(state, plaintext);
+    gift_encrypt_words_reference(ctx, state);
     store_block(ciphertext, state);
 }
 
 /* GIFT-128 decryption */
-void gift_decrypt_block(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext) {
+void gift_decrypt_block_reference(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext) {
     word32_t state[4];
 
     load_block(state, ciphertext);
@@ -241,3 +246,82 @@ void gift_decrypt_block(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t
 
     store_block(plaintext, state);
 }
+
+/*
+ * Implementation used by gift_encrypt_block/gift_decrypt_block (and so by
+ * GIFT-COFB). GIFT_BACKEND=reference|fixsliced in the environment forces one.
+ */
+typedef struct {
+    const char *name;
+    gift_words_fn encrypt_words;
+    void (*encrypt)(const gift_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext);
+    void (*decrypt)(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext);
+} gift_backend_t;
+
+/* Default first. */
+static const gift_backend_t BACKENDS[] = {
+    { "fixsliced", gift_encrypt_words_fixsliced, gift_encrypt_block_fixsliced, gift_decrypt_block_fixsliced },
+    { "reference", gift_encrypt_words_reference, gift_encrypt_block_reference, gift_decrypt_block_reference },
+};
+
+#define NUM_BACKENDS (sizeof(BACKENDS) / sizeof(BACKENDS[0]))
+
+static const gift_backend_t *active_backend = NULL;
+
+static const gift_backend_t *find_backend(const char *name) {
+    for (size_t i = 0; i < NUM_BACKENDS; i++) {
+        if (strcmp(BACKENDS[i].name, name) == 0) {
+            return &BACKENDS[i];
+        }
+    }
+    return NULL;
+}
+
+static const gift_backend_t *select_backend(void) {
+    const char *forced = getenv("GIFT_BACKEND");
+    if (forced != NULL) {
+        const gift_backend_t *b = find_backend(forced);
+        if (b != NULL) {
+            return b;
+        }
+    }
+    return &BACKENDS[0];
+}
+
+static const gift_backend_t *backend(void) {
+    const gift_backend_t *b = __atomic_load_n(&active_backend, __ATOMIC_ACQUIRE);
+    if (b == NULL) {
+        b = select_backend();
+        __atomic_store_n(&active_backend, b, __ATOMIC_RELEASE);
+    }
+    return b;
+}
+
+const char *gift_backend_name(void) {
+    return backend()->name;
+}
+
+int gift_set_backend(const char *name) {
+    const gift_backend_t *b = (name != NULL) ? find_backend(name) : select_backend();
+    if (b == NULL) {
+        return GIFT_ERR_INVALID;
+    }
+    __atomic_store_n(&active_backend, b, __ATOMIC_RELEASE);
+    return GIFT_SUCCESS;
+}
+
+gift_words_fn gift_backend_encrypt_words(void) {
+    return backend()->encrypt_words;
+}
+
+void gift_encrypt_words(const gift_ctx_t *ctx, word32_t *state) {
+    backend()->encrypt_words(ctx, state);
+}
+
+void gift_encrypt_block(const gift_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    backend()->encrypt(ctx, plaintext, ciphertext);
+}
+
+void gift_decrypt_block(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext) {
+    backend()->decrypt(ctx, ciphertext, plaintext);
+}
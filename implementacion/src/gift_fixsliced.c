@@ -0,0 +1,280 @@
+/**
+ * Fixsliced GIFT-128 (Adomnicai, Najm, Peyrin, "Fixslicing: A New GIFT
+ * Representation", TCHES 2020), adapted to the state layout, key schedule
+ * and round constants of gift.c. Outputs are identical to the reference.
+ *
+ * The state is held as four 32-bit slices: bit n of slice k is bit k of
+ * nibble n. The S-box is then a handful of bitwise operations on whole
+ * slices. The bit permutation maps every slice onto itself, but applying it
+ * in full costs ~25 operations per slice; instead the slices are left in a
+ * representation that changes from round to round and returns to the
+ * original one every five rounds. Slice 3 never moves, the other three only
+ * need a rotation inside nibbles, bytes, half-words or the word. Round keys
+ * are precomputed in the representation of the round that uses them.
+ */
+
+#include "gift_cofb.h"
+
+static const uint8_t FS_RC[40] = {
+    0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3E, 0x3D, 0x3B,
+    0x37, 0x2F, 0x1E, 0x3C, 0x39, 0x33, 0x27, 0x0E,
+    0x1D, 0x3A, 0x35, 0x2B, 0x16, 0x2C, 0x18, 0x30,
+    0x21, 0x02, 0x05, 0x0B, 0x17, 0x2E, 0x1C, 0x38,
+    0x31, 0x23, 0x06, 0x0D, 0x1B, 0x36, 0x2D, 0x1A
+};
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+/* Swaps the bits selected by mask with the bits n positions above them. */
+#define SWAPMOVE(x, mask, n) do {                           \
+    word32_t t_ = ((x) ^ ((x) >> (n))) & (mask);            \
+    (x) ^= t_ ^ (t_ << (n));                                \
+} while (0)
+
+/* Same between two words: bits of b under mask with bits of a n positions up. */
+#define SWAPMOVE2(a, b, mask, n) do {                       \
+    word32_t t_ = ((b) ^ ((a) >> (n))) & (mask);            \
+    (b) ^= t_;                                              \
+    (a) ^= t_ << (n);                                       \
+} while (0)
+
+#define NIBBLE_ROR(x, n) ((((x) >> (n)) & (0x11111111u * (0xFu >> (n)))) | \
+                          (((x) << (4 - (n))) & (0x11111111u * ((0xFu << (4 - (n))) & 0xFu))))
+#define BYTE_ROR(x, n)   ((((x) >> (n)) & (0x01010101u * (0xFFu >> (n)))) | \
+                          (((x) << (8 - (n))) & (0x01010101u * ((0xFFu << (8 - (n))) & 0xFFu))))
+#define HALF_ROR(x, n)   ((((x) >> (n)) & (0x00010001u * (0xFFFFu >> (n)))) | \
+                          (((x) << (16 - (n))) & (0x00010001u * ((0xFFFFu << (16 - (n))) & 0xFFFFu))))
+
+/*
+ * GIFT S-box on slices (s0 = least significant bit of each nibble). The
+ * final exchange of s0 and s3 is left to the caller, which passes the
+ * slices in alternating order instead.
+ */
+#define SBOX(s0, s1, s2, s3) do {   \
+    (s1) ^= (s0) & (s2);            \
+    (s0) ^= (s1) & (s3);            \
+    (s2) ^= (s0) | (s1);            \
+    (s3) ^= (s2);                   \
+    (s1) ^= (s3);                   \
+    (s3) = ~(s3);                   \
+    (s2) ^= (s0) & (s1);            \
+} while (0)
+
+#define SBOX_INV(s0, s1, s2, s3) do {   \
+    (s2) ^= (s0) & (s1);                \
+    (s3) = ~(s3);                       \
+    (s1) ^= (s3);                       \
+    (s3) ^= (s2);                       \
+    (s2) ^= (s0) | (s1);                \
+    (s0) ^= (s1) & (s3);                \
+    (s1) ^= (s0) & (s2);                \
+} while (0)
+
+/* Nibble index n, bit k -> bit 8k + n of the result: one word's share of each slice. */
+static inline word32_t nibbles_to_bytes(word32_t x) {
+    SWAPMOVE(x, 0x00AA00AAu, 7);
+    SWAPMOVE(x, 0x22222222u, 1);
+    SWAPMOVE(x, 0x0000AAAAu, 15);
+    SWAPMOVE(x, 0x0A0A0A0Au, 3);
+    return x;
+}
+
+static inline word32_t bytes_to_nibbles(word32_t x) {
+    SWAPMOVE(x, 0x0A0A0A0Au, 3);
+    SWAPMOVE(x, 0x0000AAAAu, 15);
+    SWAPMOVE(x, 0x22222222u, 1);
+    SWAPMOVE(x, 0x00AA00AAu, 7);
+    return x;
+}
+
+/* Transposes a 4x4 matrix of bytes held in four words; its own inverse. */
+static inline void transpose_bytes(word32_t *s) {
+    SWAPMOVE2(s[0], s[1], 0x00FF00FFu, 8);
+    SWAPMOVE2(s[2], s[3], 0x00FF00FFu, 8);
+    SWAPMOVE2(s[0], s[2], 0x0000FFFFu, 16);
+    SWAPMOVE2(s[1], s[3], 0x0000FFFFu, 16);
+}
+
+/* Four little-endian nibble-packed words (the reference layout) to slices. */
+static void pack(word32_t *s, const word32_t *w) {
+    for (int i = 0; i < 4; i++) {
+        s[i] = nibbles_to_bytes(w[i]);
+    }
+    transpose_bytes(s);
+}
+
+static void unpack(word32_t *w, word32_t *s) {
+    transpose_bytes(s);
+    for (int i = 0; i < 4; i++) {
+        w[i] = bytes_to_nibbles(s[i]);
+    }
+}
+
+static inline word32_t bswap32(word32_t x) {
+    return (x >> 24) | ((x >> 8) & 0x0000FF00u) | ((x << 8) & 0x00FF0000u) | (x << 24);
+}
+
+/*
+ * Round key for round r is needed in the representation reached after that
+ * round's permutation, which is P^(r%5 + 1) of the standard one (P = the
+ * permutation of slice 3). The inverse, P^(4 - r%5), as swapmoves.
+ */
+static word32_t to_round_repr(word32_t x, int j) {
+    switch (j) {
+    case 0:
+        x = bswap32(x);
+        SWAPMOVE(x, 0x22222222u, 1);
+        SWAPMOVE(x, 0x0000F0F0u, 12);
+        SWAPMOVE(x, 0x0C0C0C0Cu, 2);
+        SWAPMOVE(x, 0x00AA00AAu, 7);
+        break;
+    case 1:
+        x = bswap32(x);
+        SWAPMOVE(x, 0x0000CCCCu, 14);
+        SWAPMOVE(x, 0x00F000F0u, 4);
+        x = bswap32(x);
+        SWAPMOVE(x, 0x0000AAAAu, 15);
+        SWAPMOVE(x, 0x00CC00CCu, 6);
+        break;
+    case 2:
+        SWAPMOVE(x, 0x00CC00CCu, 6);
+        SWAPMOVE(x, 0x0000AAAAu, 15);
+        x = bswap32(x);
+        SWAPMOVE(x, 0x0000CCCCu, 14);
+        SWAPMOVE(x, 0x00F000F0u, 4);
+        x = bswap32(x);
+        break;
+    case 3:
+        SWAPMOVE(x, 0x0000FF00u, 8);
+        SWAPMOVE(x, 0x0A0A0A0Au, 3);
+        SWAPMOVE(x, 0x00F000F0u, 4);
+        SWAPMOVE(x, 0x0000CCCCu, 14);
+        x = bswap32(x);
+        break;
+    default:
+        break;
+    }
+    return x;
+}
+
+void gift_fixsliced_key_schedule(gift_ctx_t *ctx) {
+    /* Round r XORs round_keys[2r] into word 1, round_keys[2r + 1] into word 2 and the constant into word 3. */
+    word32_t k1 = nibbles_to_bytes(ctx->round_keys[1]);
+
+    for (int r = 0; r < GIFT_ROUNDS; r++) {
+        word32_t k0 = nibbles_to_bytes(ctx->round_keys[2 * r]);
+        word32_t rc = nibbles_to_bytes(FS_RC[r] & 0x3F);
+        word32_t *out = &ctx->fs_keys[4 * r];
+
+        for (int k = 0; k < 4; k++) {
+            word32_t x = ((k0 >> (8 * k)) & 0xFF) << 8 |
+                         ((k1 >> (8 * k)) & 0xFF) << 16 |
+                         ((rc >> (8 * k)) & 0xFF) << 24;
+            out[k] = to_round_repr(x, r % 5);
+        }
+        /* round_keys[2r + 3] == round_keys[2r] */
+        k1 = k0;
+    }
+}
+
+/* Five rounds; on entry a, b, c, d hold slices 0..3, on exit d, b, c, a do. */
+#define QUINTUPLE_ROUND(a, b, c, d, rk) do {                                    \
+    SBOX(a, b, c, d);                                                           \
+    d = NIBBLE_ROR(d, 1); b = NIBBLE_ROR(b, 2); c = NIBBLE_ROR(c, 3);           \
+    d ^= (rk)[0]; b ^= (rk)[1]; c ^= (rk)[2]; a ^= (rk)[3];                     \
+    SBOX(d, b, c, a);                                                           \
+    a = HALF_ROR(a, 4); b = HALF_ROR(b, 8); c = HALF_ROR(c, 12);                \
+    a ^= (rk)[4]; b ^= (rk)[5]; c ^= (rk)[6]; d ^= (rk)[7];                     \
+    SBOX(a, b, c, d);                                                           \
+    d = ROR(d, 16); SWAPMOVE(d, 0x55550000u, 1);                                \
+    SWAPMOVE(b, 0x55555555u, 1);                                                \
+    c = ROR(c, 16); SWAPMOVE(c, 0x00005555u, 1);                                \
+    d ^= (rk)[8]; b ^= (rk)[9]; c ^= (rk)[10]; a ^= (rk)[11];                   \
+    SBOX(d, b, c, a);                                                           \
+    a = BYTE_ROR(a, 6); b = BYTE_ROR(b, 4); c = BYTE_ROR(c, 2);                 \
+    a ^= (rk)[12]; b ^= (rk)[13]; c ^= (rk)[14]; d ^= (rk)[15];                 \
+    SBOX(a, b, c, d);                                                           \
+    d = ROR(d, 24); b = ROR(b, 16); c = ROR(c, 8);                              \
+    d ^= (rk)[16]; b ^= (rk)[17]; c ^= (rk)[18]; a ^= (rk)[19];                 \
+} while (0)
+
+/* Inverse of QUINTUPLE_ROUND: on entry d, b, c, a hold slices 0..3, on exit a, b, c, d do. */
+#define QUINTUPLE_ROUND_INV(a, b, c, d, rk) do {                                \
+    d ^= (rk)[16]; b ^= (rk)[17]; c ^= (rk)[18]; a ^= (rk)[19];                 \
+    d = ROR(d, 8); b = ROR(b, 16); c = ROR(c, 24);                              \
+    SBOX_INV(a, b, c, d);                                                       \
+    a ^= (rk)[12]; b ^= (rk)[13]; c ^= (rk)[14]; d ^= (rk)[15];                 \
+    a = BYTE_ROR(a, 2); b = BYTE_ROR(b, 4); c = BYTE_ROR(c, 6);                 \
+    SBOX_INV(d, b, c, a);                                                       \
+    d ^= (rk)[8]; b ^= (rk)[9]; c ^= (rk)[10]; a ^= (rk)[11];                   \
+    SWAPMOVE(d, 0x55550000u, 1); d = ROR(d, 16);                                \
+    SWAPMOVE(b, 0x55555555u, 1);                                                \
+    SWAPMOVE(c, 0x00005555u, 1); c = ROR(c, 16);                                \
+    SBOX_INV(a, b, c, d);                                                       \
+    a ^= (rk)[4]; b ^= (rk)[5]; c ^= (rk)[6]; d ^= (rk)[7];                     \
+    a = HALF_ROR(a, 12); b = HALF_ROR(b, 8); c = HALF_ROR(c, 4);                \
+    SBOX_INV(d, b, c, a);                                                       \
+    d ^= (rk)[0]; b ^= (rk)[1]; c ^= (rk)[2]; a ^= (rk)[3];                     \
+    d = NIBBLE_ROR(d, 3); b = NIBBLE_ROR(b, 2); c = NIBBLE_ROR(c, 1);           \
+    SBOX_INV(a, b, c, d);                                                       \
+} while (0)
+
+static void load_words(word32_t *w, const byte_t *block) {
+    for (int i = 0; i < 4; i++) {
+        w[i] = ((word32_t)block[4*i]) | ((word32_t)block[4*i + 1] << 8) |
+               ((word32_t)block[4*i + 2] << 16) | ((word32_t)block[4*i + 3] << 24);
+    }
+}
+
+static void store_words(byte_t *block, const word32_t *w) {
+    for (int i = 0; i < 4; i++) {
+        block[4*i] = w[i] & 0xFF;
+        block[4*i + 1] = (w[i] >> 8) & 0xFF;
+        block[4*i + 2] = (w[i] >> 16) & 0xFF;
+        block[4*i + 3] = (w[i] >> 24) & 0xFF;
+    }
+}
+
+void gift_encrypt_words_fixsliced(const gift_ctx_t *ctx, word32_t *w) {
+    word32_t s[4];
+
+    pack(s, w);
+
+    word32_t s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+    const word32_t *rk = ctx->fs_keys;
+    for (int i = 0; i < GIFT_ROUNDS; i += 10) {
+        QUINTUPLE_ROUND(s0, s1, s2, s3, rk);
+        QUINTUPLE_ROUND(s3, s1, s2, s0, rk + 20);
+        rk += 40;
+    }
+    s[0] = s0; s[1] = s1; s[2] = s2; s[3] = s3;
+
+    unpack(w, s);
+}
+
+void gift_encrypt_block_fixsliced(const gift_ctx_t *ctx, const byte_t *plaintext, byte_t *ciphertext) {
+    word32_t w[4];
+
+    load_words(w, plaintext);
+    gift_encrypt_words_fixsliced(ctx, w);
+    store_words(ciphertext, w);
+}
+
+void gift_decrypt_block_fixsliced(const gift_ctx_t *ctx, const byte_t *ciphertext, byte_t *plaintext) {
+    word32_t w[4], s[4];
+
+    load_words(w, ciphertext);
+    pack(s, w);
+
+    word32_t s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+    const word32_t *rk = ctx->fs_keys + 4 * GIFT_ROUNDS;
+    for (int i = 0; i < GIFT_ROUNDS; i += 10) {
+        rk -= 40;
+        QUINTUPLE_ROUND_INV(s3, s1, s2, s0, rk + 20);
+        QUINTUPLE_ROUND_INV(s0, s1, s2, s3, rk);
+    }
+    s[0] = s0; s[1] = s1; s[2] = s2; s[3] = s3;
+
+    unpack(w, s);
+    store_words(plaintext, w);
+}
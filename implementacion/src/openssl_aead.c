@@ -0,0 +1,183 @@
+/**
+ * ChaCha20-Poly1305 and AES-128-OCB using OpenSSL
+ */
+
+#include "openssl_aead.h"
+#include <string.h>
+#include <openssl/evp.h>
+
+static const EVP_CIPHER *alg_cipher(ossl_aead_alg_t alg) {
+    switch (alg) {
+    case OSSL_AEAD_CHACHA20_POLY1305:
+        return EVP_chacha20_poly1305();
+    case OSSL_AEAD_AES_128_OCB:
+        return EVP_aes_128_ocb();
+    }
+    return NULL;
+}
+
+size_t ossl_aead_key_size(ossl_aead_alg_t alg) {
+    return alg == OSSL_AEAD_CHACHA20_POLY1305 ? 32 : 16;
+}
+
+size_t ossl_aead_nonce_size(ossl_aead_alg_t alg) {
+    (void)alg;
+    return 12;
+}
+
+/* Cipher, nonce length and key on a fresh context; the nonce comes per message */
+static int setup(EVP_CIPHER_CTX *ctx, ossl_aead_alg_t alg, const byte_t *key, int enc) {
+    const EVP_CIPHER *cipher = alg_cipher(alg);
+
+    if (cipher == NULL ||
+        EVP_CipherInit_ex(ctx, cipher, NULL, NULL, NULL, enc) != 1 ||
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, (int)ossl_aead_nonce_size(alg), NULL) != 1 ||
+        EVP_CipherInit_ex(ctx, NULL, NULL, key, NULL, enc) != 1) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    return OSSL_AEAD_SUCCESS;
+}
+
+static int seal_message(EVP_CIPHER_CTX *ctx, const byte_t *nonce,
+                        const byte_t *ad, size_t ad_len,
+                        const byte_t *plaintext, size_t pt_len,
+                        byte_t *ciphertext, byte_t *tag) {
+    int len = 0;
+
+    if (EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, nonce) != 1) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    if (ad_len > 0 && ad != NULL) {
+        if (EVP_EncryptUpdate(ctx, NULL, &len, ad, (int)ad_len) != 1) {
+            return OSSL_AEAD_ERR_INIT;
+        }
+    }
+    len = 0;
+    if (pt_len > 0) {
+        if (EVP_EncryptUpdate(ctx, ciphertext, &len, plaintext, (int)pt_len) != 1) {
+            return OSSL_AEAD_ERR_INIT;
+        }
+    }
+    /* OCB holds back a partial block until here */
+    if (EVP_EncryptFinal_ex(ctx, ciphertext + len, &len) != 1) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, OSSL_AEAD_TAG_SIZE, tag) != 1) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    return OSSL_AEAD_SUCCESS;
+}
+
+static int open_message(EVP_CIPHER_CTX *ctx, const byte_t *nonce,
+                        const byte_t *ad, size_t ad_len,
+                        const byte_t *ciphertext, size_t ct_len,
+                        const byte_t *tag, byte_t *plaintext) {
+    int len = 0;
+
+    if (EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, nonce) != 1 ||
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, OSSL_AEAD_TAG_SIZE, (void *)tag) != 1) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    if (ad_len > 0 && ad != NULL) {
+        if (EVP_DecryptUpdate(ctx, NULL, &len, ad, (int)ad_len) != 1) {
+            return OSSL_AEAD_ERR_INIT;
+        }
+    }
+    len = 0;
+    if (ct_len > 0) {
+        if (EVP_DecryptUpdate(ctx, plaintext, &len, ciphertext, (int)ct_len) != 1) {
+            return OSSL_AEAD_ERR_INIT;
+        }
+    }
+
+    /* Finalize decryption and verify tag */
+    if (EVP_DecryptFinal_ex(ctx, plaintext + len, &len) <= 0) {
+        if (ct_len > 0) {
+            memset(plaintext, 0, ct_len);
+        }
+        return OSSL_AEAD_ERR_AUTH;
+    }
+    return OSSL_AEAD_SUCCESS;
+}
+
+int ossl_aead_encrypt(ossl_aead_alg_t alg, const byte_t *key, const byte_t *nonce,
+                      const byte_t *ad, size_t ad_len,
+                      const byte_t *plaintext, size_t pt_len,
+                      byte_t *ciphertext, byte_t *tag) {
+    EVP_CIPHER_CTX *ctx;
+    int ret = OSSL_AEAD_ERR_INIT;
+
+    if (!key || !nonce) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    ctx = EVP_CIPHER_CTX_new();
+    if (ctx != NULL && setup(ctx, alg, key, 1) == OSSL_AEAD_SUCCESS) {
+        ret = seal_message(ctx, nonce, ad, ad_len, plaintext, pt_len, ciphertext, tag);
+    }
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+int ossl_aead_decrypt(ossl_aead_alg_t alg, const byte_t *key, const byte_t *nonce,
+                      const byte_t *ad, size_t ad_len,
+                      const byte_t *ciphertext, size_t ct_len,
+                      const byte_t *tag, byte_t *plaintext) {
+    EVP_CIPHER_CTX *ctx;
+    int ret = OSSL_AEAD_ERR_INIT;
+
+    if (!key || !nonce || !tag) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    ctx = EVP_CIPHER_CTX_new();
+    if (ctx != NULL && setup(ctx, alg, key, 0) == OSSL_AEAD_SUCCESS) {
+        ret = open_message(ctx, nonce, ad, ad_len, ciphertext, ct_len, tag, plaintext);
+    }
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+int ossl_aead_key_init(ossl_aead_key_t *key, ossl_aead_alg_t alg, const byte_t *key_bytes) {
+    if (!key || !key_bytes) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+
+    key->enc = EVP_CIPHER_CTX_new();
+    key->dec = EVP_CIPHER_CTX_new();
+    if (!key->enc || !key->dec ||
+        setup(key->enc, alg, key_bytes, 1) != OSSL_AEAD_SUCCESS ||
+        setup(key->dec, alg, key_bytes, 0) != OSSL_AEAD_SUCCESS) {
+        ossl_aead_key_free(key);
+        return OSSL_AEAD_ERR_INIT;
+    }
+    return OSSL_AEAD_SUCCESS;
+}
+
+void ossl_aead_key_free(ossl_aead_key_t *key) {
+    if (!key) {
+        return;
+    }
+    EVP_CIPHER_CTX_free(key->enc);
+    EVP_CIPHER_CTX_free(key->dec);
+    key->enc = NULL;
+    key->dec = NULL;
+}
+
+int ossl_aead_encrypt_ctx(ossl_aead_key_t *key, const byte_t *nonce,
+                          const byte_t *ad, size_t ad_len,
+                          const byte_t *plaintext, size_t pt_len,
+                          byte_t *ciphertext, byte_t *tag) {
+    if (!key || !key->enc || !nonce) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    return seal_message(key->enc, nonce, ad, ad_len, plaintext, pt_len, ciphertext, tag);
+}
+
+int ossl_aead_decrypt_ctx(ossl_aead_key_t *key, const byte_t *nonce,
+                          const byte_t *ad, size_t ad_len,
+                          const byte_t *ciphertext, size_t ct_len,
+                          const byte_t *tag, byte_t *plaintext) {
+    if (!key || !key->dec || !nonce || !tag) {
+        return OSSL_AEAD_ERR_INIT;
+    }
+    return open_message(key->dec, nonce, ad, ad_len, ciphertext, ct_len, tag, plaintext);
+}
@@ -0,0 +1,264 @@
+
+#include "../include/aes_gcm.h"
+#include "../include/gift_cofb.h"
+#include "../include/openssl_aead.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*
+ * Tests for the primitives comparison_benchmark measures GFRX+COFB
+ * against. Kept out of test_gfrx_cofb so the main suite does not link
+ * OpenSSL.
+ */
+
+static void test_aes_gcm() {
+    printf("\n=== Test 1: AES-128-GCM (one-shot and keyed) ===\n");
+
+    /* NIST GCM test case 1: zero key and IV, empty message */
+    static const byte_t nist_tag[AES_TAG_SIZE] = {
+        0x58, 0xe2, 0xfc, 0xce, 0xfa, 0x7e, 0x30, 0x61,
+        0x36, 0x7f, 0x1d, 0x57, 0xa4, 0xe7, 0x45, 0x5a
+    };
+    enum { MAX_LEN = 100 };
+    byte_t key[AES_KEY_SIZE] = {0};
+    byte_t nonce[AES_NONCE_SIZE] = {0};
+    byte_t ad[20];
+    byte_t pt[MAX_LEN], ct1[MAX_LEN], ct2[MAX_LEN], dec[MAX_LEN];
+    byte_t tag1[AES_TAG_SIZE], tag2[AES_TAG_SIZE];
+    aes_gcm_key_t k;
+    int passed = 0, total = 0;
+
+    for (int i = 0; i < MAX_LEN; i++) pt[i] = i * 7;
+    for (int i = 0; i < 20; i++) ad[i] = 0xA0 + i;
+
+    /* Empty message: the tag still comes from EncryptFinal */
+    assert(aes_gcm_key_init(&k, key) == AES_GCM_SUCCESS);
+    total += 6;
+    if (aes_gcm_encrypt(key, nonce, NULL, 0, NULL, 0, NULL, tag1) == AES_GCM_SUCCESS &&
+        memcmp(tag1, nist_tag, AES_TAG_SIZE) == 0) passed++;
+    if (aes_gcm_encrypt_ctx(&k, nonce, NULL, 0, NULL, 0, NULL, tag2) == AES_GCM_SUCCESS &&
+        memcmp(tag2, nist_tag, AES_TAG_SIZE) == 0) passed++;
+    if (aes_gcm_decrypt(key, nonce, NULL, 0, NULL, 0, tag1, NULL) == AES_GCM_SUCCESS) passed++;
+    if (aes_gcm_decrypt_ctx(&k, nonce, NULL, 0, NULL, 0, tag2, NULL) == AES_GCM_SUCCESS) passed++;
+    tag1[0] ^= 1;
+    tag2[AES_TAG_SIZE - 1] ^= 0x80;
+    if (aes_gcm_decrypt(key, nonce, NULL, 0, NULL, 0, tag1, NULL) == AES_GCM_ERR_AUTH) passed++;
+    if (aes_gcm_decrypt_ctx(&k, nonce, NULL, 0, NULL, 0, tag2, NULL) == AES_GCM_ERR_AUTH) passed++;
+    aes_gcm_key_free(&k);
+
+    /* Every length up to MAX_LEN: keyed == one-shot, round trip, tamper */
+    for (int i = 0; i < AES_KEY_SIZE; i++) key[i] = i * 3 + 1;
+    assert(aes_gcm_key_init(&k, key) == AES_GCM_SUCCESS);
+    for (size_t len = 0; len < MAX_LEN; len++) {
+        size_t ad_len = len % 21;
+        nonce[0] = (byte_t)len;
+        total += 4;
+
+        aes_gcm_encrypt(key, nonce, ad, ad_len, pt, len, ct1, tag1);
+        aes_gcm_encrypt_ctx(&k, nonce, ad, ad_len, pt, len, ct2, tag2);
+        if (memcmp(ct1, ct2, len) == 0 && memcmp(tag1, tag2, AES_TAG_SIZE) == 0) passed++;
+
+        if (aes_gcm_decrypt_ctx(&k, nonce, ad, ad_len, ct1, len, tag1, dec) == AES_GCM_SUCCESS &&
+            memcmp(dec, pt, len) == 0) passed++;
+
+        tag2[len % AES_TAG_SIZE] ^= 0x01;
+        if (aes_gcm_decrypt_ctx(&k, nonce, ad, ad_len, ct1, len, tag2, dec) == AES_GCM_ERR_AUTH) passed++;
+        if (len > 0) {
+            ct1[len - 1] ^= 0x01;
+        }
+        if (aes_gcm_decrypt(key, nonce, ad, ad_len, ct1, len, len > 0 ? tag1 : tag2, dec) == AES_GCM_ERR_AUTH) passed++;
+    }
+
+    /* NULL arguments are rejected, not dereferenced */
+    total += 3;
+    if (aes_gcm_encrypt_ctx(&k, NULL, NULL, 0, pt, 16, ct1, tag1) == AES_GCM_ERR_INIT) passed++;
+    if (aes_gcm_decrypt_ctx(NULL, nonce, NULL, 0, ct1, 16, tag1, dec) == AES_GCM_ERR_INIT) passed++;
+    aes_gcm_key_free(&k);
+    if (aes_gcm_encrypt_ctx(&k, nonce, NULL, 0, pt, 16, ct1, tag1) == AES_GCM_ERR_INIT) passed++;
+
+    printf("  OK (%d/%d passed)\n", passed, total);
+    assert(passed == total);
+}
+
+static void test_gift_fixsliced() {
+    printf("\n=== Test 2: GIFT-128 fixsliced vs reference ===\n");
+
+    gift_ctx_t ctx;
+    byte_t key[GIFT_KEY_SIZE], block[GIFT_BLOCK_SIZE];
+    byte_t ref[GIFT_BLOCK_SIZE], fs[GIFT_BLOCK_SIZE], back[GIFT_BLOCK_SIZE];
+    byte_t msg[200], ct_ref[200], ct_fs[200], dec[200];
+    byte_t tag_ref[GIFT_TAG_SIZE], tag_fs[GIFT_TAG_SIZE];
+    uint32_t seed = 0x2545F491;
+    int passed = 0, total = 0;
+
+    /* Blocks under random keys: same output both ways, and decrypt inverts encrypt */
+    for (int t = 0; t < 1000; t++) {
+        for (int i = 0; i < GIFT_KEY_SIZE; i++) {
+            seed = seed * 1103515245 + 12345;
+            key[i] = seed >> 24;
+        }
+        for (int i = 0; i < GIFT_BLOCK_SIZE; i++) {
+            seed = seed * 1103515245 + 12345;
+            block[i] = seed >> 24;
+        }
+        gift_init(&ctx, key);
+        total += 2;
+
+        gift_encrypt_block_reference(&ctx, block, ref);
+        gift_encrypt_block_fixsliced(&ctx, block, fs);
+        gift_decrypt_block_fixsliced(&ctx, fs, back);
+        if (memcmp(ref, fs, GIFT_BLOCK_SIZE) == 0 && memcmp(back, block, GIFT_BLOCK_SIZE) == 0) passed++;
+
+        gift_decrypt_block_reference(&ctx, block, ref);
+        gift_decrypt_block_fixsliced(&ctx, block, fs);
+        if (memcmp(ref, fs, GIFT_BLOCK_SIZE) == 0) passed++;
+    }
+
+    /* GIFT-COFB on each backend: same output, round trip, tampered tag rejected */
+    for (size_t i = 0; i < sizeof(msg); i++) msg[i] = (byte_t)(i * 7);
+    for (size_t len = 0; len <= sizeof(msg); len += 13) {
+        total += 3;
+
+        assert(gift_set_backend("reference") == GIFT_SUCCESS);
+        gift_cofb_encrypt(key, block, msg, len / 2, msg, len, ct_ref, tag_ref);
+        assert(gift_set_backend(NULL) == GIFT_SUCCESS);
+        gift_cofb_encrypt(key, block, msg, len / 2, msg, len, ct_fs, tag_fs);
+        if (memcmp(ct_ref, ct_fs, len) == 0 && memcmp(tag_ref, tag_fs, GIFT_TAG_SIZE) == 0) passed++;
+
+        if (gift_cofb_decrypt(key, block, msg, len / 2, ct_fs, len, tag_fs, dec) == GIFT_SUCCESS &&
+            memcmp(dec, msg, len) == 0) passed++;
+
+        tag_fs[len % GIFT_TAG_SIZE] ^= 0x01;
+        if (gift_cofb_decrypt(key, block, msg, len / 2, ct_fs, len, tag_fs, dec) == GIFT_ERR_AUTH) passed++;
+    }
+
+    printf("  OK (%d/%d passed, default backend: %s)\n", passed, total, gift_backend_name());
+    assert(passed == total);
+}
+
+static void test_openssl_aead() {
+    printf("\n=== Test 3: ChaCha20-Poly1305 and AES-128-OCB ===\n");
+
+    /* RFC 8439 section 2.8.2 */
+    static const char chacha_pt[] = "Ladies and Gentlemen of the class of '99: If I could offer you "
+                                    "only one tip for the future, sunscreen would be it.";
+    static const byte_t chacha_nonce[12] = {0x07, 0, 0, 0, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    static const byte_t chacha_ad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    static const byte_t chacha_tag[16] = {
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a,
+        0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+    };
+    /* RFC 7253 appendix A, first sample: empty AD and message */
+    static const byte_t ocb_nonce[12] = {0xBB, 0xAA, 0x99, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00};
+    static const byte_t ocb_tag[16] = {
+        0x78, 0x54, 0x07, 0xBF, 0xFF, 0xC8, 0xAD, 0x9E,
+        0xDC, 0xC5, 0x52, 0x0A, 0xC9, 0x11, 0x1E, 0xE6
+    };
+    static const ossl_aead_alg_t algs[] = { OSSL_AEAD_CHACHA20_POLY1305, OSSL_AEAD_AES_128_OCB };
+    enum { MAX_LEN = 120 };
+    byte_t key[32], nonce[OSSL_AEAD_MAX_NONCE] = {0}, ad[20];
+    byte_t pt[MAX_LEN], ct1[MAX_LEN], ct2[MAX_LEN], dec[MAX_LEN];
+    byte_t tag1[OSSL_AEAD_TAG_SIZE], tag2[OSSL_AEAD_TAG_SIZE];
+    ossl_aead_key_t k;
+    int passed = 0, total = 0;
+
+    for (int i = 0; i < 32; i++) key[i] = 0x80 + i;
+    total += 2;
+    ossl_aead_encrypt(OSSL_AEAD_CHACHA20_POLY1305, key, chacha_nonce, chacha_ad, sizeof(chacha_ad),
+                      (const byte_t *)chacha_pt, sizeof(chacha_pt) - 1, ct1, tag1);
+    if (memcmp(tag1, chacha_tag, sizeof(chacha_tag)) == 0) passed++;
+    for (int i = 0; i < 16; i++) key[i] = i;
+    ossl_aead_encrypt(OSSL_AEAD_AES_128_OCB, key, ocb_nonce, NULL, 0, NULL, 0, NULL, tag1);
+    if (memcmp(tag1, ocb_tag, sizeof(ocb_tag)) == 0) passed++;
+
+    for (int i = 0; i < 20; i++) ad[i] = 0x30 + i;
+    for (int i = 0; i < MAX_LEN; i++) pt[i] = i * 5;
+
+    for (size_t a = 0; a < sizeof(algs) / sizeof(algs[0]); a++) {
+        ossl_aead_alg_t alg = algs[a];
+        assert(ossl_aead_key_init(&k, alg, key) == OSSL_AEAD_SUCCESS);
+
+        /* Keyed == one-shot, round trip, tampered tag and ciphertext rejected */
+        for (size_t len = 0; len < MAX_LEN; len += 7) {
+            size_t ad_len = len % 21;
+            nonce[0] = (byte_t)len;
+            total += 4;
+
+            ossl_aead_encrypt(alg, key, nonce, ad, ad_len, pt, len, ct1, tag1);
+            ossl_aead_encrypt_ctx(&k, nonce, ad, ad_len, pt, len, ct2, tag2);
+            if (memcmp(ct1, ct2, len) == 0 && memcmp(tag1, tag2, OSSL_AEAD_TAG_SIZE) == 0) passed++;
+
+            if (ossl_aead_decrypt_ctx(&k, nonce, ad, ad_len, ct1, len, tag1, dec) == OSSL_AEAD_SUCCESS &&
+                memcmp(dec, pt, len) == 0) passed++;
+
+            tag2[len % OSSL_AEAD_TAG_SIZE] ^= 0x01;
+            if (ossl_aead_decrypt_ctx(&k, nonce, ad, ad_len, ct1, len, tag2, dec) == OSSL_AEAD_ERR_AUTH) passed++;
+            if (len > 0) {
+                ct1[len - 1] ^= 0x01;
+            }
+            if (ossl_aead_decrypt(alg, key, nonce, ad, ad_len, ct1, len, len > 0 ? tag1 : tag2, dec) ==
+                OSSL_AEAD_ERR_AUTH) passed++;
+        }
+
+        total += 2;
+        if (ossl_aead_encrypt_ctx(&k, NULL, NULL, 0, pt, 16, ct1, tag1) == OSSL_AEAD_ERR_INIT) passed++;
+        ossl_aead_key_free(&k);
+        if (ossl_aead_decrypt_ctx(&k, nonce, NULL, 0, ct1, 16, tag1, dec) == OSSL_AEAD_ERR_INIT) passed++;
+    }
+
+    printf("  OK (%d/%d passed)\n", passed, total);
+    assert(passed == total);
+}
+
+static void test_gift_cofb_keyed() {
+    printf("\n=== Test 4: GIFT-COFB keyed calls ===\n");
+
+    enum { MAX_LEN = 100 };
+    gift_ctx_t ctx;
+    byte_t key[GIFT_KEY_SIZE], nonce[GIFT_NONCE_SIZE] = {0}, ad[20];
+    byte_t pt[MAX_LEN], ct1[MAX_LEN], ct2[MAX_LEN], dec[MAX_LEN];
+    byte_t tag1[GIFT_TAG_SIZE], tag2[GIFT_TAG_SIZE];
+    int passed = 0, total = 0;
+
+    for (int i = 0; i < GIFT_KEY_SIZE; i++) key[i] = i * 9 + 2;
+    for (int i = 0; i < 20; i++) ad[i] = i;
+    for (int i = 0; i < MAX_LEN; i++) pt[i] = i * 3;
+    assert(gift_init(&ctx, key) == GIFT_SUCCESS);
+
+    for (size_t len = 0; len < MAX_LEN; len++) {
+        size_t ad_len = len % 21;
+        nonce[0] = (byte_t)len;
+        total += 3;
+
+        gift_cofb_encrypt(key, nonce, ad, ad_len, pt, len, ct1, tag1);
+        gift_cofb_encrypt_ctx(&ctx, nonce, ad, ad_len, pt, len, ct2, tag2);
+        if (memcmp(ct1, ct2, len) == 0 && memcmp(tag1, tag2, GIFT_TAG_SIZE) == 0) passed++;
+
+        if (gift_cofb_decrypt_ctx(&ctx, nonce, ad, ad_len, ct2, len, tag2, dec) == GIFT_SUCCESS &&
+            memcmp(dec, pt, len) == 0) passed++;
+
+        tag2[len % GIFT_TAG_SIZE] ^= 0x01;
+        if (gift_cofb_decrypt_ctx(&ctx, nonce, ad, ad_len, ct2, len, tag2, dec) == GIFT_ERR_AUTH) passed++;
+    }
+
+    printf("  OK (%d/%d passed)\n", passed, total);
+    assert(passed == total);
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    printf("Comparison Primitives Test Suite\n");
+    printf("================================\n");
+
+    test_aes_gcm();
+    test_gift_fixsliced();
+    test_openssl_aead();
+    test_gift_cofb_keyed();
+
+    printf("\nAll tests completed.\n");
+    return 0;
+}
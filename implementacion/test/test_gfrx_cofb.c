@@ -1,5 +1,7 @@
 
 #include "../include/gfrx_cofb.h"
+#include "../include/gfrx_engine.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -374,6 +376,631 @@ static void test_cofb_stress() {
     printf("  OK (%d/1000 passed)\n", 1000 - failures);
 }
 
+static void test_cofb_keyed_ctx() {
+    printf("\n=== Test 13: COFB Keyed Context API ===\n");
+
+    byte_t key[GFRX_KEY_SIZE];
+    byte_t nonce[GFRX_NONCE_SIZE];
+    byte_t ad[40];
+    byte_t plaintext[200];
+    byte_t ciphertext1[200];
+    byte_t ciphertext2[200];
+    byte_t decrypted[200];
+    byte_t tag1[GFRX_TAG_SIZE];
+    byte_t tag2[GFRX_TAG_SIZE];
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key[i] = i * 31;
+    for (int i = 0; i < 40; i++) ad[i] = i * 3;
+    for (int i = 0; i < 200; i++) plaintext[i] = i * 7;
+
+    cofb_key_t ck;
+    assert(cofb_key_init(&ck, key) == GFRX_SUCCESS);
+
+    int failures = 0;
+    for (int test = 0; test < 200; test++) {
+        for (int i = 0; i < GFRX_NONCE_SIZE; i++) nonce[i] = (test >> i) & 0xFF;
+        size_t len = test;
+        size_t ad_len = test % 41;
+
+        cofb_encrypt(key, nonce, ad, ad_len, plaintext, len, ciphertext1, tag1);
+        cofb_encrypt_ctx(&ck, nonce, ad, ad_len, plaintext, len, ciphertext2, tag2);
+
+        if (memcmp(ciphertext1, ciphertext2, len) != 0 || memcmp(tag1, tag2, GFRX_TAG_SIZE) != 0) {
+            failures++;
+            continue;
+        }
+        if (cofb_decrypt_ctx(&ck, nonce, ad, ad_len, ciphertext2, len, tag2, decrypted) != GFRX_SUCCESS ||
+            memcmp(plaintext, decrypted, len) != 0) {
+            failures++;
+            continue;
+        }
+        tag2[0] ^= 0x01;
+        if (cofb_decrypt_ctx(&ck, nonce, ad, ad_len, ciphertext2, len, tag2, decrypted) != GFRX_ERR_AUTH) {
+            failures++;
+        }
+    }
+    secure_zero(&ck, sizeof(ck));
+
+    printf("  OK (%d/200 passed)\n", 200 - failures);
+}
+
+static void test_cofb_streaming() {
+    printf("\n=== Test 14: COFB Streaming API ===\n");
+
+    byte_t key[GFRX_KEY_SIZE];
+    byte_t nonce[GFRX_NONCE_SIZE];
+    byte_t ad[70];
+    byte_t plaintext[300];
+    byte_t ciphertext1[300];
+    byte_t ciphertext2[300];
+    byte_t decrypted[300];
+    byte_t tag1[GFRX_TAG_SIZE];
+    byte_t tag2[GFRX_TAG_SIZE];
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key[i] = i * 5 + 1;
+    for (int i = 0; i < 70; i++) ad[i] = i * 11;
+    for (int i = 0; i < 300; i++) plaintext[i] = i * 3;
+
+    cofb_key_t expanded;
+    cofb_key_init(&expanded, key);
+
+    srand(1234);
+    int failures = 0;
+    for (int test = 0; test < 500; test++) {
+        for (int i = 0; i < GFRX_NONCE_SIZE; i++) nonce[i] = (test * 7 + i) & 0xFF;
+        size_t ad_len = rand() % 71;
+        size_t len = rand() % 301;
+
+        cofb_encrypt(key, nonce, ad_len ? ad : NULL, ad_len, len ? plaintext : NULL, len,
+                     ciphertext1, tag1);
+
+        cofb_ctx_t ctx;
+        if (test & 1) {
+            assert(cofb_encrypt_init_key(&ctx, &expanded, nonce) == GFRX_SUCCESS);
+        } else {
+            assert(cofb_encrypt_init(&ctx, key, nonce) == GFRX_SUCCESS);
+        }
+        for (size_t off = 0; off < ad_len; ) {
+            size_t n = 1 + rand() % 20;
+            if (n > ad_len - off) n = ad_len - off;
+            cofb_encrypt_update_ad(&ctx, ad + off, n);
+            off += n;
+        }
+        for (size_t off = 0; off < len; ) {
+            size_t n = rand() % 40;
+            if (n > len - off) n = len - off;
+            cofb_encrypt_update(&ctx, plaintext + off, n, ciphertext2 + off);
+            off += n;
+        }
+        cofb_encrypt_final(&ctx, tag2);
+
+        if (memcmp(ciphertext1, ciphertext2, len) != 0 || memcmp(tag1, tag2, GFRX_TAG_SIZE) != 0) {
+            failures++;
+            continue;
+        }
+
+        assert(cofb_decrypt_init(&ctx, key, nonce) == GFRX_SUCCESS);
+        cofb_decrypt_update_ad(&ctx, ad, ad_len);
+        for (size_t off = 0; off < len; ) {
+            size_t n = 1 + rand() % 33;
+            if (n > len - off) n = len - off;
+            cofb_decrypt_update(&ctx, ciphertext2 + off, n, decrypted + off);
+            off += n;
+        }
+        if (cofb_decrypt_final(&ctx, tag2) != GFRX_SUCCESS || memcmp(plaintext, decrypted, len) != 0) {
+            failures++;
+            continue;
+        }
+
+        /* The keyed init must give the same state as the one taking raw key bytes */
+        tag2[test % GFRX_TAG_SIZE] ^= 0x80;
+        cofb_decrypt_init_key(&ctx, &expanded, nonce);
+        cofb_decrypt_update_ad(&ctx, ad, ad_len);
+        cofb_decrypt_update(&ctx, ciphertext2, len, NULL);
+        if (cofb_decrypt_final(&ctx, tag2) != GFRX_ERR_AUTH) {
+            failures++;
+        }
+    }
+
+    cofb_ctx_t ctx;
+    cofb_encrypt_init(&ctx, key, nonce);
+    cofb_encrypt_update(&ctx, plaintext, 4, ciphertext2);
+    assert(cofb_encrypt_update_ad(&ctx, ad, 4) == GFRX_ERR_INVALID);
+    cofb_encrypt_final(&ctx, tag2);
+
+    printf("  OK (%d/500 passed)\n", 500 - failures);
+}
+
+static void test_gfrx_multilane() {
+    printf("\n=== Test 15: GFRX Multi-Lane Kernels ===\n");
+
+    byte_t key[GFRX_KEY_SIZE];
+    byte_t plaintext[16 * GFRX_BLOCK_SIZE];
+    byte_t expected_sk[16 * GFRX_BLOCK_SIZE];
+    byte_t expected_mk[16 * GFRX_BLOCK_SIZE];
+    byte_t ciphertext[16 * GFRX_BLOCK_SIZE];
+
+    gfrx_ctx_t ctxs[16];
+    const gfrx_ctx_t *ctx_ptrs[16];
+    for (int l = 0; l < 16; l++) {
+        for (int i = 0; i < GFRX_KEY_SIZE; i++) key[i] = (l * 37 + i * 19) & 0xFF;
+        gfrx_init(&ctxs[l], key);
+        ctx_ptrs[l] = &ctxs[l];
+    }
+
+    int avx2 = gfrx_avx2_available();
+    int avx512 = gfrx_avx512_available();
+    int checks = 0;
+    int failures = 0;
+    for (int test = 0; test < 50; test++) {
+        for (int i = 0; i < 16 * GFRX_BLOCK_SIZE; i++) plaintext[i] = (test * 13 + i * 7) & 0xFF;
+
+        for (int l = 0; l < 16; l++) {
+            gfrx_encrypt_block(&ctxs[0], plaintext + l * GFRX_BLOCK_SIZE, expected_sk + l * GFRX_BLOCK_SIZE);
+            gfrx_encrypt_block(&ctxs[l], plaintext + l * GFRX_BLOCK_SIZE, expected_mk + l * GFRX_BLOCK_SIZE);
+        }
+
+#define CHECK_LANES(call, expected, n) do {                                     \
+            call;                                                               \
+            checks++;                                                           \
+            if (memcmp(expected, ciphertext, (n) * GFRX_BLOCK_SIZE) != 0) failures++; \
+        } while (0)
+
+        CHECK_LANES(gfrx_encrypt_blocks_x2(&ctxs[0], plaintext, ciphertext), expected_sk, 2);
+        CHECK_LANES(gfrx_encrypt_blocks_x4(&ctxs[0], plaintext, ciphertext), expected_sk, 4);
+        CHECK_LANES(gfrx_encrypt_blocks_x8(&ctxs[0], plaintext, ciphertext), expected_sk, 8);
+        CHECK_LANES(gfrx_encrypt_blocks_mk_x2(ctx_ptrs, plaintext, ciphertext), expected_mk, 2);
+        CHECK_LANES(gfrx_encrypt_blocks_mk_x4(ctx_ptrs, plaintext, ciphertext), expected_mk, 4);
+        CHECK_LANES(gfrx_encrypt_blocks_mk_x8(ctx_ptrs, plaintext, ciphertext), expected_mk, 8);
+        if (gfrx_sse2_available()) {
+            CHECK_LANES(gfrx_encrypt_blocks_sse2_x4(&ctxs[0], plaintext, ciphertext), expected_sk, 4);
+            CHECK_LANES(gfrx_encrypt_blocks_sse2_mk_x4(ctx_ptrs, plaintext, ciphertext), expected_mk, 4);
+        }
+        if (avx2) {
+            CHECK_LANES(gfrx_encrypt_blocks_avx2_x8(&ctxs[0], plaintext, ciphertext), expected_sk, 8);
+            CHECK_LANES(gfrx_encrypt_blocks_avx2_mk_x8(ctx_ptrs, plaintext, ciphertext), expected_mk, 8);
+        }
+        if (avx512) {
+            CHECK_LANES(gfrx_encrypt_blocks_avx512_x16(&ctxs[0], plaintext, ciphertext), expected_sk, 16);
+            CHECK_LANES(gfrx_encrypt_blocks_avx512_mk_x16(ctx_ptrs, plaintext, ciphertext), expected_mk, 16);
+        }
+#undef CHECK_LANES
+    }
+
+    printf("  OK (%d/%d passed%s%s)\n", checks - failures, checks,
+           avx2 ? ", AVX2" : "", avx512 ? ", AVX-512" : "");
+}
+
+static void test_gfrx_dispatch() {
+    printf("\n=== Test 16: GFRX Backend Dispatch ===\n");
+
+    static const char *backends[] = {"scalar", "sse2", "avx2", "avx512"};
+    byte_t key[GFRX_KEY_SIZE];
+    byte_t plaintext[40 * GFRX_BLOCK_SIZE];
+    byte_t expected[40 * GFRX_BLOCK_SIZE];
+    byte_t ciphertext[40 * GFRX_BLOCK_SIZE];
+
+    gfrx_ctx_t ctxs[40];
+    const gfrx_ctx_t *ctx_ptrs[40];
+    for (int l = 0; l < 40; l++) {
+        for (int i = 0; i < GFRX_KEY_SIZE; i++) key[i] = (l * 29 + i * 3) & 0xFF;
+        gfrx_init(&ctxs[l], key);
+        ctx_ptrs[l] = &ctxs[l];
+    }
+    for (int i = 0; i < 40 * GFRX_BLOCK_SIZE; i++) plaintext[i] = (i * 5) & 0xFF;
+
+    int tested = 0;
+    int failures = 0;
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+        if (gfrx_set_backend(backends[b]) != GFRX_SUCCESS) {
+            continue;
+        }
+        assert(strcmp(gfrx_backend_name(), backends[b]) == 0);
+        tested++;
+
+        for (size_t n = 0; n <= 40; n++) {
+            for (size_t l = 0; l < n; l++) {
+                gfrx_encrypt_block(&ctxs[0], plaintext + l * GFRX_BLOCK_SIZE, expected + l * GFRX_BLOCK_SIZE);
+            }
+            gfrx_encrypt_blocks(&ctxs[0], plaintext, ciphertext, n);
+            if (memcmp(expected, ciphertext, n * GFRX_BLOCK_SIZE) != 0) failures++;
+
+            for (size_t l = 0; l < n; l++) {
+                gfrx_encrypt_block(&ctxs[l], plaintext + l * GFRX_BLOCK_SIZE, expected + l * GFRX_BLOCK_SIZE);
+            }
+            gfrx_encrypt_blocks_mk(ctx_ptrs, plaintext, ciphertext, n);
+            if (memcmp(expected, ciphertext, n * GFRX_BLOCK_SIZE) != 0) failures++;
+        }
+    }
+    assert(gfrx_set_backend("no-such-backend") == GFRX_ERR_INVALID);
+    gfrx_set_backend(NULL);
+
+    printf("  OK (%d/%d passed, %d backends, auto: %s)\n", tested * 82 - failures, tested * 82,
+           tested, gfrx_backend_name());
+}
+
+static void test_cofb_batch() {
+    printf("\n=== Test 17: COFB Batch API ===\n");
+
+    enum { N = 37, MAX_LEN = 80 };
+    byte_t key_bytes[GFRX_KEY_SIZE];
+    byte_t nonces[N][GFRX_NONCE_SIZE];
+    byte_t ad[MAX_LEN];
+    byte_t pt[N][MAX_LEN];
+    byte_t ct[N][MAX_LEN], ct_ref[N][MAX_LEN], dec[N][MAX_LEN];
+    byte_t tags[N][GFRX_TAG_SIZE], tags_ref[N][GFRX_TAG_SIZE];
+    cofb_batch_msg_t msgs[N];
+    uint8_t bitmap[(N + 7) / 8];
+    cofb_key_t key;
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key_bytes[i] = (i * 7 + 1) & 0xFF;
+    for (int i = 0; i < MAX_LEN; i++) ad[i] = (i * 13) & 0xFF;
+    cofb_key_init(&key, key_bytes);
+
+    /* Mixed lengths so lanes retire and refill at different iterations. */
+    for (int m = 0; m < N; m++) {
+        size_t msg_len = (size_t)(m * 11) % MAX_LEN;
+        size_t ad_len = (size_t)(m * 5) % 35;
+        for (int i = 0; i < GFRX_NONCE_SIZE; i++) nonces[m][i] = (m * 31 + i) & 0xFF;
+        for (size_t i = 0; i < msg_len; i++) pt[m][i] = (m + i * 3) & 0xFF;
+        cofb_encrypt_ctx(&key, nonces[m], ad_len ? ad : NULL, ad_len, pt[m], msg_len, ct_ref[m], tags_ref[m]);
+        msgs[m] = (cofb_batch_msg_t){ nonces[m], ad_len ? ad : NULL, ad_len, pt[m], msg_len, ct[m], tags[m] };
+    }
+
+    int passed = 0;
+    int total = 0;
+
+    assert(cofb_encrypt_batch(&key, msgs, N) == GFRX_SUCCESS);
+    for (int m = 0; m < N; m++) {
+        total++;
+        if (memcmp(ct[m], ct_ref[m], msgs[m].in_len) == 0 && memcmp(tags[m], tags_ref[m], GFRX_TAG_SIZE) == 0) {
+            passed++;
+        }
+    }
+
+    /* Decrypt with two tampered tags; only their bits must be clear. */
+    tags[3][0] ^= 1;
+    tags[20][15] ^= 0x80;
+    for (int m = 0; m < N; m++) {
+        msgs[m] = (cofb_batch_msg_t){ nonces[m], msgs[m].ad, msgs[m].ad_len, ct[m], msgs[m].in_len, dec[m], tags[m] };
+    }
+    assert(cofb_decrypt_batch(&key, msgs, N, bitmap) == GFRX_ERR_AUTH);
+    for (int m = 0; m < N; m++) {
+        int ok = (bitmap[m / 8] >> (m % 8)) & 1;
+        total++;
+        if (m == 3 || m == 20) {
+            static const byte_t zero[MAX_LEN] = {0};
+            if (!ok && memcmp(dec[m], zero, msgs[m].in_len) == 0) passed++;
+        } else if (ok && memcmp(dec[m], pt[m], msgs[m].in_len) == 0) {
+            passed++;
+        }
+    }
+
+    tags[3][0] ^= 1;
+    tags[20][15] ^= 0x80;
+    assert(cofb_decrypt_batch(&key, msgs, N, NULL) == GFRX_SUCCESS);
+    assert(cofb_encrypt_batch(&key, msgs, 0) == GFRX_SUCCESS);
+
+    printf("  OK (%d/%d passed)\n", passed, total);
+    assert(passed == total);
+}
+
+static void test_cofb_segmented() {
+    printf("\n=== Test 18: Segmented COFB ===\n");
+
+    enum { MAX_LEN = 300, SEG = 48 };
+    byte_t key_bytes[GFRX_KEY_SIZE];
+    byte_t nonce[GFRX_NONCE_SIZE];
+    byte_t ad[7] = {1, 2, 3, 4, 5, 6, 7};
+    byte_t pt[MAX_LEN], dec[MAX_LEN];
+    byte_t ct1[MAX_LEN + 8 * GFRX_TAG_SIZE], ct4[MAX_LEN + 8 * GFRX_TAG_SIZE];
+    cofb_key_t key;
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key_bytes[i] = (i * 17 + 3) & 0xFF;
+    for (int i = 0; i < GFRX_NONCE_SIZE; i++) nonce[i] = 0xA0 + i;
+    for (int i = 0; i < MAX_LEN; i++) pt[i] = (i * 7) & 0xFF;
+    cofb_key_init(&key, key_bytes);
+
+    int passed = 0;
+    int total = 0;
+    for (size_t len = 0; len <= MAX_LEN; len += 23) {
+        size_t ct_len = cofb_segmented_len(len, SEG);
+        size_t segments = cofb_segment_count(len, SEG);
+        assert(ct_len == len + segments * GFRX_TAG_SIZE);
+
+        /* The output must not depend on the number of threads. */
+        assert(cofb_encrypt_segmented(&key, nonce, ad, sizeof(ad), pt, len, SEG, ct1, 1) == GFRX_SUCCESS);
+        assert(cofb_encrypt_segmented(&key, nonce, ad, sizeof(ad), pt, len, SEG, ct4, 4) == GFRX_SUCCESS);
+        total++;
+        if (memcmp(ct1, ct4, ct_len) == 0) passed++;
+
+        /* Segment 0 is plain COFB under the derived nonce. */
+        byte_t seg_nonce[GFRX_NONCE_SIZE], ref[SEG + GFRX_TAG_SIZE];
+        size_t first = len < SEG ? len : SEG;
+        cofb_segment_nonce(&key, nonce, 0, segments == 1, seg_nonce);
+        cofb_encrypt_ctx(&key, seg_nonce, ad, sizeof(ad), pt, first, ref, ref + first);
+        total++;
+        if (memcmp(ref, ct1, first + GFRX_TAG_SIZE) == 0) passed++;
+
+        total++;
+        if (cofb_decrypt_segmented(&key, nonce, ad, sizeof(ad), ct1, ct_len, SEG, dec, 3) == GFRX_SUCCESS &&
+            memcmp(dec, pt, len) == 0) {
+            passed++;
+        }
+
+        /* Tampering with any segment, or dropping the last one, must fail. */
+        ct1[ct_len / 2] ^= 0x40;
+        total++;
+        if (cofb_decrypt_segmented(&key, nonce, ad, sizeof(ad), ct1, ct_len, SEG, dec, 2) == GFRX_ERR_AUTH) {
+            passed++;
+        }
+        ct1[ct_len / 2] ^= 0x40;
+
+        if (segments > 1) {
+            size_t trunc_len = (segments - 1) * (SEG + GFRX_TAG_SIZE);
+            total++;
+            if (cofb_decrypt_segmented(&key, nonce, ad, sizeof(ad), ct1, trunc_len, SEG, dec, 2) == GFRX_ERR_AUTH) {
+                passed++;
+            }
+        }
+    }
+
+    printf("  OK (%d/%d passed)\n", passed, total);
+    assert(passed == total);
+}
+
+static int engine_callbacks = 0;
+
+static void engine_count_done(gfrx_job_t *job) {
+    (void)job;
+    __atomic_add_fetch(&engine_callbacks, 1, __ATOMIC_RELAXED);
+}
+
+static void test_gfrx_engine() {
+    printf("\n=== Test 19: Work-Stealing Engine ===\n");
+
+    enum { N = 60, SEG = 64, BIG = 5000 };
+    static byte_t pt[N][BIG], ct[N][2 * BIG], ref[N][2 * BIG], dec[N][BIG];
+    byte_t key_bytes[GFRX_KEY_SIZE];
+    byte_t nonces[N][GFRX_NONCE_SIZE];
+    byte_t tags[N][GFRX_TAG_SIZE], ref_tags[N][GFRX_TAG_SIZE];
+    size_t lens[N];
+    gfrx_job_t jobs[N];
+    cofb_key_t key;
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key_bytes[i] = (i * 11 + 5) & 0xFF;
+    cofb_key_init(&key, key_bytes);
+
+    /* Every fifth job is a large segmented one, the rest are small plain messages. */
+    for (int j = 0; j < N; j++) {
+        lens[j] = (j % 5 == 0) ? (size_t)(BIG - j) : (size_t)(j * 3);
+        for (int i = 0; i < GFRX_NONCE_SIZE; i++) nonces[j][i] = (j * 13 + i) & 0xFF;
+        for (size_t i = 0; i < lens[j]; i++) pt[j][i] = (j + i * 7) & 0xFF;
+        if (j % 5 == 0) {
+            cofb_encrypt_segmented(&key, nonces[j], NULL, 0, pt[j], lens[j], SEG, ref[j], 1);
+        } else {
+            cofb_encrypt_ctx(&key, nonces[j], NULL, 0, pt[j], lens[j], ref[j], ref_tags[j]);
+        }
+    }
+
+    gfrx_engine_t *engine = gfrx_engine_create(3);
+    assert(engine != NULL && gfrx_engine_threads(engine) == 3);
+
+    /* Encrypt through the completion queue. */
+    memset(jobs, 0, sizeof(jobs));
+    for (int j = 0; j < N; j++) {
+        jobs[j] = (gfrx_job_t){ .op = GFRX_JOB_ENCRYPT, .key = &key, .nonce = nonces[j],
+                                .in = pt[j], .in_len = lens[j], .out = ct[j], .tag = tags[j],
+                                .segment_size = (j % 5 == 0) ? SEG : 0 };
+        assert(gfrx_engine_submit(engine, &jobs[j]) == GFRX_SUCCESS);
+    }
+    int completed = 0;
+    gfrx_job_t *job;
+    while ((job = gfrx_engine_wait(engine)) != NULL) {
+        assert(job->result == GFRX_SUCCESS);
+        completed++;
+    }
+
+    int passed = 0;
+    int total = 0;
+    for (int j = 0; j < N; j++) {
+        total++;
+        if (j % 5 == 0) {
+            if (memcmp(ct[j], ref[j], cofb_segmented_len(lens[j], SEG)) == 0) passed++;
+        } else if (memcmp(ct[j], ref[j], lens[j]) == 0 && memcmp(tags[j], ref_tags[j], GFRX_TAG_SIZE) == 0) {
+            passed++;
+        }
+    }
+
+    /* Decrypt with callbacks; jobs 5 (segmented) and 7 (plain) are tampered. */
+    ct[5][100] ^= 1;
+    tags[7][0] ^= 1;
+    for (int j = 0; j < N; j++) {
+        int seg = (j % 5 == 0);
+        jobs[j] = (gfrx_job_t){ .op = GFRX_JOB_DECRYPT, .key = &key, .nonce = nonces[j],
+                                .in = ct[j], .in_len = seg ? cofb_segmented_len(lens[j], SEG) : lens[j],
+                                .out = dec[j], .tag = tags[j], .segment_size = seg ? SEG : 0,
+                                .done = engine_count_done };
+        assert(gfrx_engine_submit(engine, &jobs[j]) == GFRX_SUCCESS);
+    }
+    gfrx_engine_drain(engine);
+    assert(gfrx_engine_wait(engine) == NULL);
+
+    total++;
+    if (engine_callbacks == N) passed++;
+    for (int j = 0; j < N; j++) {
+        total++;
+        if (j == 5 || j == 7) {
+            if (jobs[j].result == GFRX_ERR_AUTH) passed++;
+        } else if (jobs[j].result == GFRX_SUCCESS && memcmp(dec[j], pt[j], lens[j]) == 0) {
+            passed++;
+        }
+    }
+
+    gfrx_engine_destroy(engine);
+
+    printf("  OK (%d/%d passed, %d jobs via completion queue)\n", passed, total, completed);
+    assert(passed == total && completed == N);
+}
+
+static void test_cofb_segment_ranges() {
+    printf("\n=== Test 20: Segment Ranges ===\n");
+
+    enum { MAX_LEN = 300, SEG = 32, STRIDE = SEG + GFRX_TAG_SIZE };
+    byte_t key_bytes[GFRX_KEY_SIZE];
+    byte_t nonce[GFRX_NONCE_SIZE] = {9, 8, 7, 6, 5, 4, 3, 2};
+    byte_t ad[3] = {0xAD, 0xAD, 0xAD};
+    byte_t pt[MAX_LEN], dec[MAX_LEN];
+    byte_t ct[MAX_LEN + 16 * GFRX_TAG_SIZE], parts[MAX_LEN + 16 * GFRX_TAG_SIZE];
+    cofb_key_t key;
+
+    for (int i = 0; i < GFRX_KEY_SIZE; i++) key_bytes[i] = 0x40 + i;
+    for (int i = 0; i < MAX_LEN; i++) pt[i] = (i * 13 + 1) & 0xFF;
+    cofb_key_init(&key, key_bytes);
+
+    int passed = 0;
+    int total = 0;
+    for (size_t len = 0; len <= MAX_LEN; len += 37) {
+        size_t ct_len = cofb_segmented_len(len, SEG);
+        size_t segments = cofb_segment_count(len, SEG);
+        assert(cofb_encrypt_segmented(&key, nonce, ad, sizeof(ad), pt, len, SEG, ct, 2) == GFRX_SUCCESS);
+
+        /* Any split into a head of whole segments and a final tail gives the same bytes. */
+        for (size_t k = 0; k < segments; k++) {
+            int ok = 1;
+            if (k > 0) {
+                ok &= cofb_encrypt_segments(&key, nonce, ad, sizeof(ad), 0, 0, pt, k * SEG,
+                                            SEG, parts, 2) == GFRX_SUCCESS;
+            }
+            ok &= cofb_encrypt_segments(&key, nonce, ad, sizeof(ad), k, 1, pt + k * SEG, len - k * SEG,
+                                        SEG, parts + k * STRIDE, 1) == GFRX_SUCCESS;
+            total++;
+            if (ok && memcmp(parts, ct, ct_len) == 0) passed++;
+        }
+
+        /* A middle range decrypts on its own, but not when claimed to be final. */
+        if (segments > 2) {
+            total++;
+            if (cofb_decrypt_segments(&key, nonce, ad, sizeof(ad), 1, 0, ct + STRIDE, STRIDE,
+                                      SEG, dec, 2) == GFRX_SUCCESS &&
+                memcmp(dec, pt + SEG, SEG) == 0) {
+                passed++;
+            }
+            total++;
+            if (cofb_decrypt_segments(&key, nonce, ad, sizeof(ad), 1, 1, ct + STRIDE, STRIDE,
+                                      SEG, dec, 2) == GFRX_ERR_AUTH) {
+                passed++;
+            }
+        }
+
+        /* The tail decrypts from its index; a short segment is only valid in a final range. */
+        size_t k = segments - 1;
+        total++;
+        if (cofb_decrypt_segments(&key, nonce, ad, sizeof(ad), k, 1, ct + k * STRIDE, ct_len - k * STRIDE,
+                                  SEG, dec, 1) == GFRX_SUCCESS &&
+            memcmp(dec, pt + k * SEG, len - k * SEG) == 0) {
+            passed++;
+        }
+        if (len % SEG != 0) {
+            total++;
+            if (cofb_decrypt_segments(&key, nonce, ad, sizeof(ad), k, 0, ct + k * STRIDE, ct_len - k * STRIDE,
+                                      SEG, dec, 1) == GFRX_ERR_INVALID) {
+                passed++;
+            }
+        }
+
+        /* plaintext == NULL only checks the tags. */
+        total++;
+        if (cofb_decrypt_segments(&key, nonce, ad, sizeof(ad), 0, 1, ct, ct_len, SEG, NULL, 2) == GFRX_SUCCESS) {
+            passed++;
+        }
+        ct[ct_len - 1] ^= 1;
+        total++;
+        if (cofb_decrypt_segments(&key, nonce, ad, sizeof(ad), 0, 1, ct, ct_len, SEG, NULL, 2) == GFRX_ERR_AUTH) {
+            passed++;
+        }
+        ct[ct_len - 1] ^= 1;
+    }
+
+    printf("  OK (%d/%d passed)\n", passed, total);
+    assert(passed == total);
+}
+
+
+#define NONCE_THREADS       4
+#define NONCES_PER_THREAD   20000
+
+static cofb_nonce_gen_t shared_nonces;
+static uint64_t drawn_nonces[NONCE_THREADS * NONCES_PER_THREAD];
+
+static void *nonce_drawer(void *arg) {
+    uint64_t *out = arg;
+    byte_t nonce[GFRX_NONCE_SIZE];
+    for (int i = 0; i < NONCES_PER_THREAD; i++) {
+        cofb_nonce_next(&shared_nonces, nonce);
+        out[i] = 0;
+        for (int j = GFRX_NONCE_SIZE - 1; j >= 0; j--) out[i] = (out[i] << 8) | nonce[j];
+    }
+    return NULL;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void test_cofb_nonce_gen() {
+    printf("\n=== Test 21: Nonce Generator ===\n");
+
+    int passed = 0;
+    int total = 0;
+    cofb_nonce_gen_t gen;
+    byte_t nonce[GFRX_NONCE_SIZE];
+    byte_t batch[3 * GFRX_NONCE_SIZE];
+
+    /* Counter values are little-endian and consecutive, across the 32-bit boundary too. */
+    cofb_nonce_init_counter(&gen, 0xFFFFFFFFull);
+    cofb_nonce_next(&gen, nonce);
+    const byte_t expect0[GFRX_NONCE_SIZE] = {0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0};
+    total++;
+    if (memcmp(nonce, expect0, GFRX_NONCE_SIZE) == 0) passed++;
+
+    cofb_nonce_next_n(&gen, batch, 3);
+    const byte_t expect1[3 * GFRX_NONCE_SIZE] = {0, 0, 0, 0, 1, 0, 0, 0,  1, 0, 0, 0, 1, 0, 0, 0,
+                                                 2, 0, 0, 0, 1, 0, 0, 0};
+    total++;
+    if (memcmp(batch, expect1, sizeof(batch)) == 0) passed++;
+
+    /* Two seeded generators start at different points. */
+    cofb_nonce_gen_t a, b;
+    byte_t na[GFRX_NONCE_SIZE], nb[GFRX_NONCE_SIZE];
+    total++;
+    if (cofb_nonce_init(&a) == GFRX_SUCCESS && cofb_nonce_init(&b) == GFRX_SUCCESS) {
+        cofb_nonce_next(&a, na);
+        cofb_nonce_next(&b, nb);
+        if (memcmp(na, nb, GFRX_NONCE_SIZE) != 0) passed++;
+    }
+
+    /* Threads sharing one generator never see the same nonce. */
+    pthread_t threads[NONCE_THREADS];
+    cofb_nonce_init(&shared_nonces);
+    for (int t = 0; t < NONCE_THREADS; t++) {
+        pthread_create(&threads[t], NULL, nonce_drawer, drawn_nonces + t * NONCES_PER_THREAD);
+    }
+    for (int t = 0; t < NONCE_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    qsort(drawn_nonces, NONCE_THREADS * NONCES_PER_THREAD, sizeof(uint64_t), compare_u64);
+    int dups = 0;
+    for (int i = 1; i < NONCE_THREADS * NONCES_PER_THREAD; i++) {
+        if (drawn_nonces[i] == drawn_nonces[i - 1]) dups++;
+    }
+    total++;
+    if (dups == 0) passed++;
+
+    printf("  OK (%d/%d passed)\n", passed, total);
+    assert(passed == total);
+}
 
 int main(int argc, char *argv[]) {
     (void)argc;
@@ -394,6 +1021,15 @@ int main(int argc, char *argv[]) {
     test_cofb_authentication();
     test_cofb_nonce_uniqueness();
     test_cofb_stress();
+    test_cofb_keyed_ctx();
+    test_cofb_streaming();
+    test_gfrx_multilane();
+    test_gfrx_dispatch();
+    test_cofb_batch();
+    test_cofb_segmented();
+    test_gfrx_engine();
+    test_cofb_segment_ranges();
+    test_cofb_nonce_gen();
 
     printf("\nAll tests completed.\n");
     return 0;